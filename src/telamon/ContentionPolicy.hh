@@ -0,0 +1,226 @@
+#ifndef TELAMON_CONTENTION_POLICY_HH
+#define TELAMON_CONTENTION_POLICY_HH
+
+//! \file 		ContentionPolicy.hh
+//! \brief 		Definitions of ContentionFailureCounter, Backoff and ContentionPolicy
+//! \details 	A contention policy configures when the simulator gives up on the fast-path and how threads wait between retries
+//! 			of a failed CAS. It is a compile-time parameter of WaitFreeSimulator and WaitFreeSimulatorHandle. The counters it
+//! 			creates carry the thresholds and the backoff strategy to every place which detects contention, including the
+//! 			retry loop of VersionedAtomic::compare_exchange_strong. The policy also decides how the owner of an operation on
+//! 			the slow-path waits for the helpers (see SlowPathWait). A handle may additionally skip the fast-path while it is
+//! 			predicted to fail (see PathPredictor).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace telamon_simulator {
+
+/// \brief The way a thread waits before retrying after contention was detected
+enum class BackoffKind : char {
+  None,         //< Retry immediately
+  Exponential,  //< Spin a random number of pauses, the upper bound doubling after each failure
+  Pause         //< Spin a fixed number of pauses
+};
+
+/// \brief Hint to the processor that the calling thread is spinning
+inline void cpu_relax () noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+/// \brief Block until `word` no longer holds `expected`, `timeout` passes or the thread is woken by `unpark`
+/// \note  May return spuriously
+inline void park (std::atomic<uint32_t> &word, const uint32_t expected, const std::chrono::microseconds timeout) noexcept {
+#ifdef __linux__
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	const auto ts = timespec{static_cast<time_t>(seconds.count()),
+	                         static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count())};
+	(void) syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+#else
+	// std::atomic::wait has no timeout
+	if (word.load() == expected) { std::this_thread::sleep_for(timeout); }
+#endif
+}
+
+/// \brief Wake every thread parked on `word`
+inline void unpark (std::atomic<uint32_t> &word) noexcept {
+#ifdef __linux__
+	(void) syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+#else
+	(void) word;
+#endif
+}
+
+/// \brief How the owner of an operation on the slow-path waits between its rounds of helping
+/// \details The owner first spins for `spin_rounds` rounds, then yields for `yield_rounds` rounds and finally parks until the
+/// 		  helper which completes the operation wakes it. A parked owner wakes up after `park_timeout` microseconds anyway
+/// 		  and helps again, so that its operation completes even if no other thread is helping.
+struct SlowPathWait {
+  /// The default never stops spinning, which keeps the latency of the slow-path the lowest
+  int spin_rounds{std::numeric_limits<int>::max()};
+  int yield_rounds{0};
+  std::chrono::microseconds::rep park_timeout{200};
+
+  enum class Step : char { Spin, Yield, Park };
+
+  /// \brief What to do after round number `round` (starting from 0) did not complete the operation
+  [[nodiscard]] constexpr auto step (const int round) const noexcept -> Step {
+	  if (round < spin_rounds) { return Step::Spin; }
+	  if (round - spin_rounds < yield_rounds) { return Step::Yield; }
+	  return Step::Park;
+  }
+};
+
+/// \brief Estimates whether the fast-path of the next operation of a handle is going to fail from the outcomes of the recent ones
+/// \details The estimate is an exponential moving average in fixed point (SCALE stands for 1). A fast-path which fails moves it
+/// 		  1 / 2^weight_shift of the way to SCALE and one which succeeds the same way to 0. While the estimate is above
+/// 		  `threshold`, operations go straight to the slow-path. Each of them decays the estimate by 1 / 2^decay_shift, so that
+/// 		  the fast-path is tried again after a few operations and the estimate drops further once contention subsides.
+/// \note 	Owned by a single handle, thus not thread-safe
+struct PathPredictor {
+  constexpr static inline int SCALE = 1 << 16;
+
+  int weight_shift{2};
+  int decay_shift{4};
+  int threshold{SCALE / 2};
+  int estimate{0};
+
+  [[nodiscard]] constexpr auto skip_fast_path () const noexcept -> bool { return estimate > threshold; }
+
+  /// \brief Account for an operation which tried the fast-path
+  constexpr void record (const bool fast_path_failed) noexcept {
+	  estimate += ((fast_path_failed ? SCALE : 0) - estimate) >> weight_shift;
+  }
+
+  /// \brief Account for an operation which skipped the fast-path
+  constexpr void record_skip () noexcept { estimate -= estimate >> decay_shift; }
+};
+
+/// \brief A backoff strategy. The number of pauses is measured in cpu_relax calls.
+struct Backoff {
+  BackoffKind kind{BackoffKind::None};
+  int min_spins{4};
+  int max_spins{1024};
+
+  /// \brief Wait before retry number `attempt` (starting from 1)
+  void wait (const int attempt) const noexcept {
+	  switch (kind) {
+		  case BackoffKind::None:
+			  return;
+		  case BackoffKind::Pause:
+			  spin(min_spins);
+			  return;
+		  case BackoffKind::Exponential: {
+			  const auto shift = std::clamp(attempt - 1, 0, 30);
+			  const auto bound = static_cast<int>(std::min<int64_t>(max_spins, int64_t{min_spins} << shift));
+			  // Full jitter, so that threads which failed together do not retry together
+			  spin(static_cast<int>(next_random() % static_cast<uint32_t>(bound + 1)));
+			  return;
+		  }
+	  }
+  }
+
+ private:
+  static void spin (const int spins) noexcept {
+	  for (int i = 0; i < spins; ++i) { cpu_relax(); }
+  }
+
+  static auto next_random () noexcept -> uint32_t {
+	  // xorshift32, seeded per thread by the address of the state
+	  thread_local uint32_t state = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&state) >> 4) | 1u;
+	  state ^= state << 13;
+	  state ^= state >> 17;
+	  state ^= state << 5;
+	  return state;
+  }
+};
+
+/// \brief Measures the contention which was encountered during simulation
+/// \details Keeps an internal counter of the detected contention and responds according to it.
+class ContentionFailureCounter {
+ public:
+  constexpr static inline int THRESHOLD = 2;
+  constexpr static inline int FAST_PATH_RETRY_THRESHOLD = 3;
+
+ public:
+  ContentionFailureCounter () = default;
+
+  explicit ContentionFailureCounter (int t_threshold, Backoff t_backoff = {})
+	  : m_threshold{t_threshold}, m_backoff{t_backoff} {}
+
+ public:
+  auto detect () -> bool {
+	  return (++m_counter > m_threshold);
+  }
+  [[nodiscard]] auto get () const noexcept -> int { return m_counter; }
+
+  /// \brief Wait according to the backoff strategy before retrying. The wait grows with the detected contention.
+  void backoff () const noexcept { m_backoff.wait(std::max(m_counter, 1)); }
+
+ private:
+  int m_counter{0};
+  int m_threshold{THRESHOLD};
+  Backoff m_backoff{};
+};
+
+/// \brief Compile-time configuration of the contention management of the simulator
+/// \tparam Threshold 		The number of contention failures after which an operation gives up
+/// \tparam FastPathRetries The number of times an operation tries the fast-path before switching to the slow-path
+/// \tparam Kind 			The backoff strategy used between retries
+/// \tparam MinSpins 		The number of pauses of a Pause backoff and the initial bound of an Exponential one
+/// \tparam MaxSpins 		The maximum bound of an Exponential backoff
+/// \tparam Wait 			How the owner of an operation on the slow-path waits for the helpers
+template<int Threshold = ContentionFailureCounter::THRESHOLD,
+         int FastPathRetries = ContentionFailureCounter::FAST_PATH_RETRY_THRESHOLD,
+         BackoffKind Kind = BackoffKind::None,
+         int MinSpins = 4,
+         int MaxSpins = 1024,
+         SlowPathWait Wait = SlowPathWait{}>
+struct ContentionPolicy {
+  static_assert(Threshold >= 0 && FastPathRetries >= 0, "Thresholds cannot be negative.");
+  static_assert(0 < MinSpins && MinSpins <= MaxSpins, "Spin bounds have to satisfy 0 < MinSpins <= MaxSpins.");
+
+  constexpr static inline int THRESHOLD = Threshold;
+  constexpr static inline int FAST_PATH_RETRIES = FastPathRetries;
+  constexpr static inline Backoff BACKOFF{Kind, MinSpins, MaxSpins};
+  constexpr static inline SlowPathWait WAIT = Wait;
+
+  static auto make_counter () -> ContentionFailureCounter { return ContentionFailureCounter{THRESHOLD, BACKOFF}; }
+};
+
+/// \brief The policy used unless another one is specified. Matches the original hard-coded behaviour.
+using DefaultContentionPolicy = ContentionPolicy<>;
+
+/// \brief Like the default policy, but the owner of an operation on the slow-path soon leaves its CPU to the helpers. Meant
+/// 	   for oversubscribed machines.
+using ParkingContentionPolicy = ContentionPolicy<ContentionFailureCounter::THRESHOLD,
+                                                 ContentionFailureCounter::FAST_PATH_RETRY_THRESHOLD,
+                                                 BackoffKind::None, 4, 1024,
+                                                 SlowPathWait{.spin_rounds = 16, .yield_rounds = 16}>;
+
+/// \brief Requires a type to be usable as a contention policy of the simulator
+template<typename Policy>
+concept ContentionManagement = requires {
+	{ Policy::FAST_PATH_RETRIES } -> std::convertible_to<int>;
+	{ Policy::make_counter() } -> std::same_as<ContentionFailureCounter>;
+	{ Policy::WAIT } -> std::convertible_to<SlowPathWait>;
+};
+
+}
+
+#endif // TELAMON_CONTENTION_POLICY_HH
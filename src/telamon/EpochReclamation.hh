@@ -0,0 +1,148 @@
+#ifndef TELAMON_EPOCH_RECLAMATION_HH
+#define TELAMON_EPOCH_RECLAMATION_HH
+
+//! \file 		EpochReclamation.hh
+//! \brief 		Definitions of EpochDomain and EpochGuard
+//! \details 	Used by the simulator to reclaim the operation records which get replaced during helping. The participants are
+//! 			the ids of the simulator handles. An object retired in epoch `e` is freed once the global epoch reaches `e + 2`,
+//! 			i.e. once every participant which could have observed it has left its critical section.
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "SegmentedArray.hh"
+
+namespace telamon_simulator {
+
+/// \brief This module contains the epoch-based reclamation scheme used for the operation records of the simulator
+namespace epoch_reclamation {
+
+using Epoch = uint_least64_t;
+
+/// \brief An epoch domain shared by participants indexed by their ids. Participants register on their first `enter`, in
+/// 	   segments of N.
+template<const int N>
+class EpochDomain {
+ public:
+  constexpr static inline int EPOCHS = 3;
+  /// Number of objects a participant retires before it tries to advance the global epoch
+  constexpr static inline std::size_t RECLAIM_BATCH = 64;
+
+  /// \brief An object which is retired but may still be referenced by another participant
+  struct Retired {
+	void *ptr;
+	void (*deleter) (void *);
+  };
+
+  /// \brief The state of a single participant. Only `local_epoch` and `active` are read by other participants.
+  struct alignas(64) Participant {
+	std::atomic<Epoch> local_epoch{0};
+	std::atomic<bool> active{false};
+	int nesting{0};
+	std::array<std::vector<Retired>, EPOCHS> limbo{};
+	std::size_t num_retired{0};
+  };
+
+ public:
+  EpochDomain () = default;
+  EpochDomain (const EpochDomain &) = delete;
+  auto operator= (const EpochDomain &) -> EpochDomain & = delete;
+
+  ~EpochDomain () {
+	  m_participants.for_each([] (std::size_t, Participant &participant) {
+		for (auto &bucket : participant.limbo) {
+			free_bucket(bucket);
+		}
+	  });
+  }
+
+ public:
+  /// \brief Enter a critical section. Nested calls by the same participant are allowed.
+  void enter (const int id) {
+	  auto &self = m_participants.ensure(id);
+	  if (self.nesting++ > 0) { return; }
+
+	  const auto epoch = m_epoch.load();
+	  const auto previous = self.local_epoch.load(std::memory_order_relaxed);
+	  self.local_epoch.store(epoch);
+	  self.active.store(true);
+	  if (epoch != previous) {
+		  // Everything retired two or more epochs ago cannot be observed anymore
+		  free_bucket(self.limbo.at((epoch + 1) % EPOCHS));
+	  }
+  }
+
+  /// \brief Leave the critical section entered with `enter`
+  void leave (const int id) {
+	  auto &self = m_participants[id];
+	  if (--self.nesting > 0) { return; }
+	  self.active.store(false);
+  }
+
+  /// \brief Hand over an object which is no longer reachable. Has to be called inside a critical section.
+  void retire (const int id, void *ptr, void (*deleter) (void *)) {
+	  auto &self = m_participants[id];
+	  // Stamped with the global epoch, which may be one ahead of the local one. A participant which entered in the newer
+	  // epoch may still hold the object, thus it has to wait for two epochs from then on.
+	  self.limbo.at(m_epoch.load() % EPOCHS).push_back(Retired{ptr, deleter});
+	  if (++self.num_retired % RECLAIM_BATCH == 0) {
+		  (void) try_advance();
+	  }
+  }
+
+  template<typename T>
+  void retire (const int id, T *ptr) {
+	  retire(id, static_cast<void *>(ptr), [] (void *p) { delete static_cast<T *>(p); });
+  }
+
+  /// \brief Advance the global epoch if every active participant has already observed it
+  auto try_advance () -> bool {
+	  auto epoch = m_epoch.load();
+	  bool observed = true;
+	  m_participants.for_each([&] (std::size_t, const Participant &participant) {
+		observed = observed && !(participant.active.load() && participant.local_epoch.load() != epoch);
+	  });
+	  if (!observed) { return false; }
+	  return m_epoch.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  [[nodiscard]] auto epoch () const noexcept -> Epoch { return m_epoch.load(); }
+
+  /// \brief The number of objects retired by a participant which are still not reclaimed
+  [[nodiscard]] auto retired_count (const int id) const -> std::size_t {
+	  std::size_t count = 0;
+	  if (!m_participants.contains(id)) { return count; }   //< Never entered
+	  for (auto &bucket : m_participants[id].limbo) { count += bucket.size(); }
+	  return count;
+  }
+
+ private:
+  static void free_bucket (std::vector<Retired> &bucket) {
+	  for (auto &r : bucket) { r.deleter(r.ptr); }
+	  bucket.clear();
+  }
+
+ private:
+  std::atomic<Epoch> m_epoch{0};
+  SegmentedArray<Participant, N> m_participants;
+};
+
+/// \brief Keeps a participant inside a critical section for the lifetime of the guard
+template<const int N>
+class EpochGuard {
+ public:
+  EpochGuard (EpochDomain<N> &t_domain, const int t_id) : m_domain{t_domain}, m_id{t_id} { m_domain.enter(m_id); }
+  EpochGuard (const EpochGuard &) = delete;
+  ~EpochGuard () { m_domain.leave(m_id); }
+
+ private:
+  EpochDomain<N> &m_domain;
+  const int m_id;
+};
+
+}
+}
+
+#endif // TELAMON_EPOCH_RECLAMATION_HH
@@ -0,0 +1,314 @@
+#ifndef TELAMON_HAZARD_POINTERS_HH
+#define TELAMON_HAZARD_POINTERS_HH
+
+//! \file 		HazardPointers.hh
+//! \brief 		Definitions of HazardPointerDomain and the free functions used to protect and retire shared cells
+//! \details 	Every thread which touches a protected structure owns a single record of the domain. The record holds a small
+//! 			number of hazard slots, a list of overflow hazards for the guards beyond them and a private list of retired
+//! 			objects which is reclaimed in batches.
+
+#include <atomic>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace telamon_simulator {
+
+/// \brief This module contains the hazard pointer domain used for safe memory reclamation of shared cells
+namespace hazard_pointers {
+
+template<typename T>
+class HazardGuard;
+
+/// \brief A domain of hazard pointers. Records are acquired lazily by each thread and are reused after the thread exits.
+/// \note  There is a single domain per process (see `global`) because the record of a thread is cached in a thread_local.
+class HazardPointerDomain {
+ public:
+  constexpr static inline int SLOTS_PER_RECORD = 8;
+  /// The first ROTATING_SLOTS slots are handed out to guards by `protect_guarded`. Every guard owns its slot while it lives.
+  /// Further guards take overflow hazards.
+  constexpr static inline int ROTATING_SLOTS = 4;
+  /// Lower bound of the number of retired objects which triggers a reclamation pass
+  constexpr static inline std::size_t MIN_RECLAIM_BATCH = 64;
+
+  /// \brief An object which is retired but may still be referenced by another thread
+  struct Retired {
+	void *ptr;
+	void (*deleter) (void *);
+  };
+
+  /// \brief A hazard of a guard which did not find a free rotating slot
+  struct OverflowHazard {
+	std::atomic<void *> hazard{nullptr};
+	/// Only accessed by the thread which currently owns the record
+	bool held{false};
+	OverflowHazard *next{nullptr};
+  };
+
+  /// \brief The part of the domain owned by a single thread
+  struct alignas(64) Record {
+	std::array<std::atomic<void *>, SLOTS_PER_RECORD> hazards{};
+	std::atomic<bool> in_use{false};
+	Record *next{nullptr};
+	/// Only accessed by the thread which currently owns the record
+	std::vector<Retired> retired{};
+	/// Bit i is set while rotating slot i is owned by a guard
+	uint8_t held{0};
+	/// Pushed by the owner only and never unlinked, thus the scanning threads traverse it without protection
+	std::atomic<OverflowHazard *> overflow{nullptr};
+  };
+
+ public:
+  HazardPointerDomain (const HazardPointerDomain &) = delete;
+  auto operator= (const HazardPointerDomain &) -> HazardPointerDomain & = delete;
+
+  ~HazardPointerDomain () {
+	  auto *rec = m_records.load();
+	  while (rec) {
+		  for (auto &r : rec->retired) { r.deleter(r.ptr); }
+		  for (auto *node = rec->overflow.load(); node;) { delete std::exchange(node, node->next); }
+		  auto *next = rec->next;
+		  delete rec;
+		  rec = next;
+	  }
+  }
+
+  /// \brief The domain used by VersionedAtomic and the simulator
+  static auto global () -> HazardPointerDomain & {
+	  static HazardPointerDomain domain;
+	  return domain;
+  }
+
+ public:
+  /// \brief Obtain the record of the calling thread, registering the thread in the domain if needed
+  auto attach () -> Record & {
+	  thread_local ThreadRecord local{*this};
+	  return *local.record;
+  }
+
+  /// \brief Protect the pointer stored in `src` using a given slot of the calling thread's record
+  /// \return The protected pointer. It is safe to dereference it until the slot is cleared or reused.
+  template<typename T>
+  auto protect (const std::atomic<T *> &src, int slot) -> T * {
+	  return protect_in(attach().hazards.at(slot), src);
+  }
+
+  /// \brief Protect the pointer stored in `src` using a free rotating slot, which is owned by the returned guard
+  /// \note  Once all of the ROTATING_SLOTS slots are held, the guard takes an overflow hazard of the record instead, which is
+  /// 		 allocated the first time it is needed. A thread may thus hold any number of guards.
+  template<typename T>
+  auto protect_guarded (const std::atomic<T *> &src) -> HazardGuard<T>;
+
+  void clear (int slot) { attach().hazards.at(slot).store(nullptr, std::memory_order_release); }
+
+  /// \brief Hand over an object which is no longer reachable from the shared structure
+  void retire (void *ptr, void (*deleter) (void *)) {
+	  auto &rec = attach();
+	  rec.retired.push_back(Retired{ptr, deleter});
+	  if (rec.retired.size() >= reclaim_batch()) {
+		  scan(rec);
+	  }
+  }
+
+  template<typename T>
+  void retire (T *ptr) {
+	  retire(static_cast<void *>(ptr), [] (void *p) { delete static_cast<T *>(p); });
+  }
+
+  /// \brief Reclaim every retired object of the calling thread which is not protected
+  void reclaim () { scan(attach()); }
+
+  /// \brief Check whether any thread currently protects any of the given pointers
+  template<typename ...Ptrs>
+  [[nodiscard]] auto is_protected (const Ptrs *... ptrs) const -> bool {
+	  bool found = false;
+	  for (auto *rec = m_records.load(); rec && !found; rec = rec->next) {
+		  for_each_hazard(*rec, [&] (const std::atomic<void *> &hazard) {
+			const auto *ptr = hazard.load();
+			found = found || ((ptr == static_cast<const void *>(ptrs)) || ...);
+		  });
+	  }
+	  return found;
+  }
+
+  /// \brief The number of objects retired by the calling thread which are still not reclaimed
+  [[nodiscard]] auto retired_count () -> std::size_t { return attach().retired.size(); }
+
+ private:
+  HazardPointerDomain () = default;
+
+  /// \brief Releases the record of a thread when it exits
+  struct ThreadRecord {
+	HazardPointerDomain &domain;
+	Record *record;
+	explicit ThreadRecord (HazardPointerDomain &t_domain) : domain{t_domain}, record{t_domain.acquire()} {}
+	~ThreadRecord () { domain.release(record); }
+  };
+
+  auto acquire () -> Record * {
+	  for (auto *rec = m_records.load(); rec; rec = rec->next) {
+		  auto expected = false;
+		  if (!rec->in_use.load() && rec->in_use.compare_exchange_strong(expected, true)) {
+			  return rec;
+		  }
+	  }
+
+	  auto *rec = new Record{};
+	  rec->in_use.store(true);
+	  auto *head = m_records.load();
+	  do {
+		  rec->next = head;
+	  } while (!m_records.compare_exchange_weak(head, rec));
+	  m_num_records.fetch_add(1);
+	  return rec;
+  }
+
+  void release (Record *rec) {
+	  for_each_hazard(*rec, [] (std::atomic<void *> &hazard) { hazard.store(nullptr); });
+	  scan(*rec);
+	  // Whatever is still protected stays in the record and is reclaimed by its next owner
+	  rec->in_use.store(false);
+  }
+
+  template<typename T>
+  static auto protect_in (std::atomic<void *> &hazard, const std::atomic<T *> &src) -> T * {
+	  auto *ptr = src.load();
+	  while (true) {
+		  hazard.store(ptr);
+		  auto *reloaded = src.load();
+		  if (reloaded == ptr) { return ptr; }
+		  ptr = reloaded;
+	  }
+  }
+
+  /// \brief Take a free overflow hazard of the calling thread's record, or push a new one
+  static auto acquire_overflow (Record &rec) -> OverflowHazard & {
+	  for (auto *node = rec.overflow.load(); node; node = node->next) {
+		  if (!node->held) {
+			  node->held = true;
+			  return *node;
+		  }
+	  }
+	  auto *node = new OverflowHazard{};
+	  node->held = true;
+	  node->next = rec.overflow.load();
+	  rec.overflow.store(node);
+	  return *node;
+  }
+
+  /// \brief Invoke `fun` with the rotating and fixed slots of a record and with its overflow hazards
+  template<typename R, typename Fun>
+  static void for_each_hazard (R &rec, Fun &&fun) {
+	  for (auto &hazard : rec.hazards) { fun(hazard); }
+	  for (auto *node = rec.overflow.load(); node; node = node->next) { fun(node->hazard); }
+  }
+
+  [[nodiscard]] auto reclaim_batch () const -> std::size_t {
+	  return std::max(MIN_RECLAIM_BATCH, 2 * SLOTS_PER_RECORD * m_num_records.load());
+  }
+
+  void scan (Record &owner) {
+	  if (owner.retired.empty()) { return; }
+
+	  std::vector<void *> protected_ptrs;
+	  protected_ptrs.reserve(SLOTS_PER_RECORD * m_num_records.load());
+	  for (auto *rec = m_records.load(); rec; rec = rec->next) {
+		  for_each_hazard(*rec, [&] (const std::atomic<void *> &hazard) {
+			if (auto *ptr = hazard.load(); ptr) { protected_ptrs.push_back(ptr); }
+		  });
+	  }
+	  std::ranges::sort(protected_ptrs);
+
+	  // Deleters may retire further objects, so they must not observe the list being iterated
+	  auto candidates = std::vector<Retired>{};
+	  candidates.swap(owner.retired);
+	  for (auto &r : candidates) {
+		  if (std::ranges::binary_search(protected_ptrs, r.ptr)) {
+			  owner.retired.push_back(r);
+		  } else {
+			  r.deleter(r.ptr);
+		  }
+	  }
+  }
+
+ private:
+  std::atomic<Record *> m_records{nullptr};
+  std::atomic<std::size_t> m_num_records{0};
+};
+
+/// \brief A pointer protected by a rotating slot (or an overflow hazard) of the thread which created the guard. The slot is
+/// 	   released when the guard is destroyed, thus the guard must not outlive its thread nor be handed over to another one.
+template<typename T>
+class HazardGuard {
+ public:
+  HazardGuard (HazardPointerDomain::Record &t_record, const int t_slot, T *t_ptr) noexcept
+	  : m_record{&t_record}, m_slot{t_slot}, m_ptr{t_ptr} {}
+
+  HazardGuard (HazardPointerDomain::Record &t_record, HazardPointerDomain::OverflowHazard &t_overflow, T *t_ptr) noexcept
+	  : m_record{&t_record}, m_overflow{&t_overflow}, m_ptr{t_ptr} {}
+
+  HazardGuard (HazardGuard &&rhs) noexcept
+	  : m_record{std::exchange(rhs.m_record, nullptr)}, m_slot{rhs.m_slot}, m_overflow{rhs.m_overflow}, m_ptr{rhs.m_ptr} {}
+
+  HazardGuard (const HazardGuard &) = delete;
+  auto operator= (const HazardGuard &) -> HazardGuard & = delete;
+  auto operator= (HazardGuard &&) -> HazardGuard & = delete;
+
+  ~HazardGuard () {
+	  if (!m_record) { return; }
+	  if (m_overflow) {
+		  m_overflow->hazard.store(nullptr, std::memory_order_release);
+		  m_overflow->held = false;
+	  } else {
+		  m_record->hazards[m_slot].store(nullptr, std::memory_order_release);
+		  m_record->held &= static_cast<uint8_t>(~(1u << m_slot));
+	  }
+  }
+
+ public:
+  [[nodiscard]] auto get () const noexcept -> T * { return m_ptr; }
+  auto operator-> () const noexcept -> T * { return m_ptr; }
+  auto operator* () const noexcept -> T & { return *m_ptr; }
+  friend auto operator== (const HazardGuard &guard, std::nullptr_t) noexcept -> bool { return guard.m_ptr == nullptr; }
+
+ private:
+  HazardPointerDomain::Record *m_record;
+  int m_slot{-1};
+  /// Set if the guard did not find a free rotating slot
+  HazardPointerDomain::OverflowHazard *m_overflow{nullptr};
+  T *m_ptr;
+};
+
+template<typename T>
+auto HazardPointerDomain::protect_guarded (const std::atomic<T *> &src) -> HazardGuard<T> {
+	auto &rec = attach();
+	constexpr auto all_held = static_cast<uint8_t>((1u << ROTATING_SLOTS) - 1);
+	if (rec.held == all_held) {
+		auto &overflow = acquire_overflow(rec);
+		return HazardGuard<T>{rec, overflow, protect_in(overflow.hazard, src)};
+	}
+	const auto slot = std::countr_one(rec.held);
+	rec.held |= static_cast<uint8_t>(1u << slot);
+	return HazardGuard<T>{rec, slot, protect(src, slot)};
+}
+
+/// \brief Protect a pointer in the global domain for as long as the returned guard lives
+template<typename T>
+auto protect (const std::atomic<T *> &src) -> HazardGuard<T> {
+	return HazardPointerDomain::global().protect_guarded(src);
+}
+
+/// \brief Retire an object in the global domain
+template<typename T>
+void retire (T *ptr) {
+	HazardPointerDomain::global().retire(ptr);
+}
+
+}
+}
+
+#endif // TELAMON_HAZARD_POINTERS_HH
@@ -1,19 +1,30 @@
 /*
  * \file HelpQueue.hh
- * \brief Provides an implementation of a wait-free queue with support for
- * limited operations
+ * \brief Provides an implementation of a wait-free multi-producer multi-consumer
+ * queue, which also serves as the help queue of the simulator
  */
 #ifndef TELAMON_HELP_QUEUE_HH
 #define TELAMON_HELP_QUEUE_HH
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <cstdint>
 #include <memory>
 #include <numeric>
 #include <thread>
 #include <typeinfo>
 #include <optional>
 #include <ranges>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "HazardPointers.hh"
+#include "SegmentedArray.hh"
+#include "Tracing.hh"
 
 #ifdef TEL_LOGGING
 #include <extern/loguru/loguru.hpp>
@@ -24,26 +35,83 @@ thread_local std::thread::id current_thread_id = std::this_thread::get_id();
 /// \brief This module contains the implementation of a wait-free queue used as an underlying structure in the simulation - "help queue"
 namespace helpqueue {
 
+/// \brief Storage mode in which every node and operation description is allocated on the heap and never reclaimed
+struct HeapNodes {
+  constexpr static inline int RING_SIZE = 0;
+};
+
+/// \brief Storage mode in which each enqueuer id owns a ring of RingSize preallocated slots (a node and its two operation
+/// 	   descriptions). A slot is recycled once its node has been dequeued and no helper protects any part of it, which makes
+/// 	   enqueueing allocation-free. If every slot of the ring is still in use, an overflow slot of the enqueuer is used
+/// 	   instead. Overflow slots are allocated once, recycled like the ring and freed together with the queue.
+template<const int RingSize = 4>
+struct PreallocatedNodes {
+  static_assert(RingSize > 1, "The node of the last enqueue may still be the dummy head of the queue.");
+  constexpr static inline int RING_SIZE = RingSize;
+};
+
+/// \brief Layout in which the shared fields of the queue and the states of the enqueuers are packed together
+struct PackedLayout {
+  constexpr static inline std::size_t ALIGNMENT = 1;
+};
+
+/// \brief Layout in which the head, the tail, the phase counter, the pending bitmap and the state of every enqueuer start on a
+/// 	   cache line of their own. An enqueuer publishing its state then does not invalidate the head read by `peek_front`,
+/// 	   nor the state of its neighbours, at the cost of a cache line per enqueuer.
+struct CacheAlignedLayout {
+  constexpr static inline std::size_t ALIGNMENT = 64;
+};
+
 /// \brief This is the main class representing the help queue
-template<typename T, const int N = 16>
+/// \details The state of the enqueuers is kept in segments of N. Enqueuer ids beyond N register themselves on their first
+/// 		 push_back, and the helping scans only cover the enqueuers which have registered so far.
+/// 		 The simulator dequeues with `peek_front` and `try_pop_front`. In heap mode the queue can also be used as a
+/// 		 general-purpose wait-free queue through `pop_front`, which dequeues unconditionally and supports move-only
+/// 		 elements. Dequeuers take their ids from the same range as the enqueuers.
+template<typename T, const int N = 16, typename Storage = HeapNodes, typename Layout = PackedLayout>
 class HelpQueue {
  public:
   struct Node;
   struct OperationDescription;
-  enum class Operation : int { enqueue };
+  struct Slot;
+  struct Participant;
+  enum class Operation : int { enqueue, dequeue };
+  /// Wide enough to never wrap around
+  using Phase = int64_t;
+
+  constexpr static inline bool PREALLOCATED = !std::is_same_v<Storage, HeapNodes>;
+
+  /// The alignment of a field of type U in the layout
+  template<typename U>
+  constexpr static inline std::size_t ALIGNMENT_OF = std::max(Layout::ALIGNMENT, alignof(U));
 
  public:
-  constexpr HelpQueue () {
+  HelpQueue () {
 #ifdef TEL_LOGGING
   	  loguru::add_file("helpqueue.log", loguru::Append, loguru::Verbosity_MAX);
 #endif
 
-	  m_head.store(Node::SENTITEL_NODE.get());
-	  m_tail.store(Node::SENTITEL_NODE.get());
+	  m_head.store(m_sentinel.get());
+	  m_tail.store(m_sentinel.get());
+  }
 
-	  std::ranges::for_each(m_states, [] (auto &state) {
-		state.store(OperationDescription::EMPTY.get());
-	  });
+  HelpQueue (const HelpQueue &) = delete;
+  auto operator= (const HelpQueue &) -> HelpQueue & = delete;
+
+  /// \brief In heap mode, frees the nodes which are still linked and the current states. Whatever has been replaced or
+  /// 		 dequeued before was retired to the hazard pointer domain.
+  ~HelpQueue () {
+	  if constexpr (!PREALLOCATED) {
+		  for (auto *node = m_head.load(); node;) {
+			  auto *next = node->next().load();
+			  if (node != m_sentinel.get()) { delete node; }
+			  node = next;
+		  }
+		  m_participants.for_each([this] (std::size_t, Participant &participant) {
+			auto *state = participant.state.load();
+			if (state != m_empty.get()) { delete state; }
+		  });
+	  }
   }
 
  public:
@@ -52,48 +120,78 @@ class HelpQueue {
   /// \param element The element to be enqueued
   /// \param enqueuer The id of the thread which enqueues the element
   void push_back (const int enqueuer, T element) {
-#ifdef TEL_LOGGING
-	  LOG_S(INFO)
-	  << "Thread '" << current_thread_id << "': push_back with value " << element << " type T = [" << typeid(T).name()
-	  << "]\n";
-#endif
-	  int phase = max_phase().value_or(-1) + 1;
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': Calculated phase = " << phase << '\n';
-#endif
-	  // TODO: Change `new` when hazard pointers are used
-	  auto *node = new Node{element, enqueuer};
-	  auto *description = new OperationDescription{phase, true, Operation::enqueue, node};
-	  m_states.at(enqueuer).store(description);
-
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id
-				  << "': State updated with initial OperationDescription for push_back operation.\n";
-#endif
+	  // Later than the phase of every enqueue which has already started, so that those are helped first
+	  const auto phase = m_phase.fetch_add(1, std::memory_order_relaxed);
+	  auto &self = participant(enqueuer);
+	  OperationDescription *description;
+	  if constexpr (PREALLOCATED) {
+		  auto *slot = acquire_slot(self);
+		  slot->node.reset(std::move(element), enqueuer, slot);
+		  slot->pending = OperationDescription{phase, true, Operation::enqueue, &slot->node};
+		  slot->done = OperationDescription{phase, false, Operation::enqueue, &slot->node};
+		  description = &slot->pending;
+	  } else {
+		  auto *node = new Node{std::move(element), enqueuer};
+		  description = new OperationDescription{phase, true, Operation::enqueue, node};
+	  }
+	  retire_description(self.state.exchange(description));
+	  mark_pending(enqueuer);
+	  telamon_simulator::tracing::trace(telamon_simulator::tracing::TraceEventKind::QueuePush, enqueuer, description->node(), static_cast<int>(phase));
 
 	  help_others(phase);
+	  // A helper finishing the previous enqueue of this enqueuer may have just cleared its bit, thus it is not left to the scan
+	  help_enqueue(enqueuer, phase);
 	  help_finish_enqueue();
+	  clear_hazards();
+	  self.enqueued.store(self.enqueued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  ///
+  /// \brief Dequeue the element at the head of the queue
+  /// \param dequeuer The id of the thread which dequeues the element
+  /// \return The element, or empty if the queue was empty
+  /// \details The dequeuer publishes its operation like an enqueuer and every thread which observes it helps: the dummy head
+  /// 		  is recorded in the state of the dequeuer and claimed by setting its dequeuer, after which anybody may move the
+  /// 		  head past it. Only in heap mode, since the states of the dequeues are not preallocated.
+  std::optional<T> pop_front (const int dequeuer) requires (!PREALLOCATED) {
+	  const auto phase = m_phase.fetch_add(1, std::memory_order_relaxed);
+	  auto &self = participant(dequeuer);
+	  retire_description(self.state.exchange(new OperationDescription{phase, true, Operation::dequeue, nullptr}));
+	  mark_pending(dequeuer);
+
+	  help_others(phase);
+	  help_dequeue(dequeuer, phase);
+	  help_finish_dequeue();
+	  clear_hazards();
+
+	  // The old dummy head, whose successor holds the element and is the new dummy head. Neither can be reclaimed before
+	  // this dequeuer has released them.
+	  auto *first = self.state.load()->node();
+	  telamon_simulator::tracing::trace(telamon_simulator::tracing::TraceEventKind::QueuePop, dequeuer, first, first != nullptr);
+	  if (!first) {
+		  return std::nullopt;
+	  }
+	  auto *next = first->next().load();
+	  first->mark_dequeued();
+	  count_dequeue(*next);
+	  auto data = std::optional<T>{next->take_data()};
+	  release_node(next);
+	  release_node(first);
+	  return data;
   }
 
   ///
   /// \brief Peek the head of the queue
   /// \return The value of the head if one is present and empty if not
   std::optional<T> peek_front () const {
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': Peeking the front of the help queue." << '\n';
-#endif
-	  auto next = m_head.load()->next().load();
-
+	  auto [head, next] = protect_front();
 	  if (!next) {
-#ifdef TEL_LOGGING
-		  LOG_S(INFO) << "Thread '" << current_thread_id << "': The help queue is empty." << '\n';
-#endif
+		  clear_hazards();
 		  return std::nullopt;
 	  }
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': The help queue's head points to data = " << next->data() << '\n';
-#endif
-	  return {next->data()};
+	  auto data = std::optional<T>{next->data()};
+	  clear_hazards();
+	  return data;
   }
 
   ///
@@ -102,37 +200,76 @@ class HelpQueue {
   /// \param expected_head The value which the head is expected to be
   /// \return Whether the dequeue succeeded or not
   bool try_pop_front (T expected_head) {
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': Trying to pop the front of the help queue (expecting data = " << expected_head << ")\n";
-#endif
-	  auto head_ptr = m_head.load();
-	  auto next_ptr = head_ptr->next().load();
+	  auto [head_ptr, next_ptr] = protect_front();
 	  if (!next_ptr || next_ptr->data() != expected_head) {
-
-#ifdef TEL_LOGGING
-		  LOG_S(INFO) << "Thread '" << current_thread_id << "': The help queue is empty." << '\n';
-#endif
+		  clear_hazards();
 		  return false;
 	  }
 
-	  if (m_head.compare_exchange_strong(head_ptr, next_ptr)) {
+	  if constexpr (!PREALLOCATED) {
+		  // Claimed like the dummy head of a pop_front, so that the two never dequeue the same element
+		  const auto claimed = head_ptr->claim(CONDITIONAL_DEQUEUER);
+		  help_finish_dequeue();
+		  clear_hazards();
+		  telamon_simulator::tracing::trace(telamon_simulator::tracing::TraceEventKind::QueuePop, -1, next_ptr, claimed);
+		  if (claimed) {
+			  // Neither node can be reclaimed before it is released here, although their protection has been cleared
+			  head_ptr->mark_dequeued();
+			  count_dequeue(*next_ptr);
+			  release_node(next_ptr);
+			  release_node(head_ptr);
+		  }
+		  return claimed;
+	  } else if (m_head.compare_exchange_strong(head_ptr, next_ptr)) {
 		  help_finish_enqueue();
 		  head_ptr->set_next(nullptr);
-#ifdef TEL_LOGGING
-		  LOG_S(INFO) << "Thread '" << current_thread_id << "': CAS during try_pop_front was successful" << '\n';
-#endif
+		  // The old dummy head is not reachable anymore. In preallocated mode its slot can be recycled by its enqueuer.
+		  head_ptr->mark_dequeued();
+		  count_dequeue(*next_ptr);
+		  clear_hazards();
+		  telamon_simulator::tracing::trace(telamon_simulator::tracing::TraceEventKind::QueuePop, -1, next_ptr, true);
 		  return true;
 	  }
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': CAS during try_pop_front FAILED" << '\n';
-#endif
+	  telamon_simulator::tracing::trace(telamon_simulator::tracing::TraceEventKind::QueuePop, -1, next_ptr, false);
+	  clear_hazards();
 	  return false;
   }
 
+  ///
+  /// \brief Check whether the given enqueuer can push_back without allocating
+  /// \return True in heap mode and iff one of the preallocated slots of the enqueuer can be recycled otherwise
+  [[nodiscard]] bool has_free_slot (const int enqueuer) {
+	  if constexpr (PREALLOCATED) {
+		  auto &self = participant(enqueuer);
+		  return std::ranges::any_of(self.ring, [&] (const Slot &slot) {
+			return is_recyclable(self, slot);
+		  });
+	  }
+	  return true;
+  }
+
+  ///
+  /// \brief The number of overflow slots the given enqueuer has allocated because its whole ring was in use
+  [[nodiscard]] std::size_t overflow_slots (const int enqueuer) {
+	  return participant(enqueuer).overflow.size();
+  }
+
+  ///
+  /// \brief The number of elements in the queue
+  /// \details Approximate while operations are in progress, since an element is counted when its enqueue returns and when
+  /// 		   its dequeue is claimed. Every enqueuer counts its own elements, thus no counter is shared by all threads.
+  [[nodiscard]] std::size_t size () const {
+	  int64_t total = 0;
+	  m_participants.for_each([&] (std::size_t, const Participant &participant) {
+		total += participant.enqueued.load(std::memory_order_relaxed) - participant.dequeued.load(std::memory_order_relaxed);
+	  });
+	  return total > 0 ? static_cast<std::size_t>(total) : 0;
+  }
+
  private:  //< Helper functions
 
-  bool is_pending (int state_id, int phase_limit) {
-	  auto state_ptr = m_states.at(state_id).load();
+  bool is_pending (int state_id, Phase phase_limit) {
+	  auto state_ptr = protect(m_participants[state_id].state, HAZARD_SCAN);
 	  return state_ptr->pending() && state_ptr->phase() <= phase_limit;
   }
 
@@ -142,50 +279,41 @@ class HelpQueue {
   /// values and performs simple checks to be sure that no other thread has already performed the updates. Following
   /// that, the operation state gets updated and its value as well as the tail pointer are CAS-ed with the new values.
   void help_finish_enqueue () {
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "' in helping to finish push_back operation.\n";
-#endif
-	  auto tail_ptr = m_tail.load();
-	  auto next_ptr = tail_ptr->next().load();
-	  if (!next_ptr) {
-#ifdef TEL_LOGGING
-		  LOG_S(INFO) << "Thread '" << current_thread_id << "': Tail pointer correctly put.\n";
-#endif
+	  auto tail_ptr = protect(m_tail, HAZARD_NODE);
+	  auto next_ptr = protect(tail_ptr->next(), HAZARD_NEXT);
+	  // A tail which has moved on may have a successor which is already dequeued and reclaimed
+	  if (!next_ptr || tail_ptr != m_tail.load()) {
 		  return;
 	  }
 
-	  // Id's value is valid since next cannot be Node::SENTINEL
+	  // Id's value is valid since next cannot be the sentinel
 	  auto id = next_ptr->enqueuer_id();
-	  auto /* std::atomic<OperationDescription*> */ old_state_ptr = m_states.at(id).load();
+	  auto /* std::atomic<OperationDescription*> */ old_state_ptr = protect(m_participants[id].state, HAZARD_STATE);
 
-	  if (tail_ptr != m_tail.load()) {
-#ifdef TEL_LOGGING
-		  LOG_S(INFO) << "Thread '" << current_thread_id << "': Tail pointer updated.\n";
-#endif
+	  if (old_state_ptr->operation() != Operation::enqueue || old_state_ptr->node() != next_ptr) {
 		  return;
 	  }
 
-	  if (old_state_ptr->node() != next_ptr) {
-#ifdef TEL_LOGGING
-		  LOG_S(INFO) << "Thread '" << current_thread_id << "': The thread which started this operation has already changed the node it is working "
-															"on, thus this operation has already finished.\n";
-#endif
-		  return;
+	  OperationDescription *updated_state_ptr;
+	  if constexpr (PREALLOCATED) {
+		  // Prepared by the enqueuer together with the pending description
+		  updated_state_ptr = &next_ptr->slot()->done;
+	  } else {
+		  updated_state_ptr = new OperationDescription{
+			  old_state_ptr->phase(),
+			  false,
+			  Operation::enqueue,
+			  old_state_ptr->node()
+		  };
 	  }
 
-	  // TODO: Change `new` when proper memory reclamation scheme is added (hazard pointers).
-	  auto updated_state_ptr = new OperationDescription{
-		  old_state_ptr->phase(),
-		  false,
-		  Operation::enqueue,
-		  old_state_ptr->node()
-	  };
-
 	  // Update
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': Performing CAS-es on the state and on the tail.\n";
-#endif
-	  (void) m_states.at(id).compare_exchange_weak(old_state_ptr, updated_state_ptr);
+	  if (m_participants[id].state.compare_exchange_weak(old_state_ptr, updated_state_ptr)) {
+		  retire_description(old_state_ptr);
+		  clear_pending(id);
+	  } else {
+		  discard_description(updated_state_ptr);
+	  }
 	  (void) m_tail.compare_exchange_strong(tail_ptr, next_ptr);
   }
 
@@ -196,102 +324,266 @@ class HelpQueue {
   /// performs checks on them. This is done in order to observe whether modifications (from another thread) have been
   /// made during this function's execution. After all of them have passed and it is sure that the pair is consistent,
   /// the helping thread tries to update the operation descriptor and then CAS the new value by finishing the push_back operation.
-  void help_enqueue (int state_idx, int helper_phase) {
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Thread '" << current_thread_id << "': Starting to help Thread '" << state_idx << "' with by having phase = " << helper_phase
-	  << '\n';
-#endif
+  void help_enqueue (int state_idx, Phase helper_phase) {
 	  while (is_pending(state_idx, helper_phase)) {
 
-		  auto *tail_ptr = m_tail.load();
+		  auto *tail_ptr = protect(m_tail, HAZARD_NODE);
 		  auto &tail = *tail_ptr;
-		  auto *next_ptr = tail_ptr->next().load();
+		  auto *next_ptr = protect(tail_ptr->next(), HAZARD_NEXT);
 
 		  if (tail_ptr != m_tail.load()) {
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Thread '" << current_thread_id << "': Tail pointer modified. Retrying ...\n";
-#endif
 			  continue;
 		  }
 
 		  if (next_ptr != nullptr) {
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Thread '" << current_thread_id << "': Tail pointer outdated. Retrying ...\n";
-#endif
 			  help_finish_enqueue();
 			  continue;
 		  }
 
 		  if (!is_pending(state_idx, helper_phase)) {
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Thread '" << current_thread_id << "': Operation already executed. Done.\n";
-#endif
 			  return;
 		  }
 
-		  auto *state_ptr = m_states.at(state_idx).load();
+		  auto *state_ptr = protect(m_participants[state_idx].state, HAZARD_STATE);
 		  auto state = *state_ptr;
 		  if (!state.pending()) {
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Thread '" << current_thread_id << "': Operation already executed. Done.\n";
-#endif
 			  return;
 		  }
 
 		  auto *new_next_ptr = state_ptr->node();
 		  if (tail.next().compare_exchange_strong(next_ptr, new_next_ptr)) {
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Thread '" << current_thread_id << "' in helping Thread '" << state_idx
-						  << "': CAS on tail, next and node.\n";
-#endif
+			  telamon_simulator::tracing::trace(telamon_simulator::tracing::TraceEventKind::QueueHelpEnqueue, -1, new_next_ptr, state_idx);
 			  return help_finish_enqueue();
 		  }
 	  }
   }
 
-  void help_others (int helper_phase) {
-#ifdef TEL_LOGGING
-	  LOG_S(INFO)
-	  << "Thread '" << current_thread_id << "': Helping others with helper phase = " << helper_phase << '\n';
-#endif
-	  int i = 0;
-	  for (auto &atomic_state : m_states) {
-		  auto state = atomic_state.load();
-		  if (state->pending() && state->phase() <= helper_phase) {
-			  if (state->operation() == Operation::enqueue) {
-#ifdef TEL_LOGGING
-				  LOG_S(INFO)
-				  << "Thread '" << current_thread_id << "': Found operation which needs help - Thread '" << i
-				  << "' which is performing push_back with phase = " << helper_phase << '\n';
-#endif
-				  help_enqueue(i, helper_phase);
+  /// \brief Help another thread dequeue
+  /// \param state_idx The index in the state array corresponding to the operation
+  /// \param helper_phase The phase of the helper
+  /// \details The dequeue completes as empty if the queue is observed empty. Otherwise the current dummy head is recorded in
+  /// 		  the state of the dequeuer and claimed for it, unless another dequeue has already claimed it, in which case that
+  /// 		  one is finished first and the next head is tried.
+  void help_dequeue (int state_idx, Phase helper_phase) requires (!PREALLOCATED) {
+	  auto &state = m_participants[state_idx].state;
+	  while (is_pending(state_idx, helper_phase)) {
+		  // Only compared, thus not protected: the emptiness is confirmed against the current tail
+		  auto *last = m_tail.load();
+		  auto [first, next] = protect_front();
+
+		  if (first == last) {
+			  if (next != nullptr) {
+				  help_finish_enqueue();
+				  continue;
+			  }
+			  auto *state_ptr = protect(state, HAZARD_STATE);
+			  if (last == m_tail.load() && is_pending(state_idx, helper_phase)) {
+				  auto *empty = new OperationDescription{state_ptr->phase(), false, Operation::dequeue, nullptr};
+				  if (state.compare_exchange_strong(state_ptr, empty)) {
+					  retire_description(state_ptr);
+					  clear_pending(state_idx);
+				  } else {
+					  discard_description(empty);
+				  }
+			  }
+			  continue;
+		  }
+
+		  auto *state_ptr = protect(state, HAZARD_STATE);
+		  if (!state_ptr->pending() || state_ptr->phase() > helper_phase) {
+			  return;
+		  }
+		  if (first == m_head.load() && state_ptr->node() != first) {
+			  auto *updated = new OperationDescription{state_ptr->phase(), true, Operation::dequeue, first};
+			  if (!state.compare_exchange_strong(state_ptr, updated)) {
+				  discard_description(updated);
+				  continue;
+			  }
+			  retire_description(state_ptr);
+		  }
+		  (void) first->claim(state_idx);
+		  help_finish_dequeue();
+	  }
+  }
+
+  /// \brief Completes the dequeue which has claimed the dummy head, if any, and moves the head past it
+  void help_finish_dequeue () requires (!PREALLOCATED) {
+	  auto [first, next] = protect_front();
+	  const auto id = first->dequeuer();
+	  if (id == NO_DEQUEUER || next == nullptr) {
+		  return;
+	  }
+
+	  if (id != CONDITIONAL_DEQUEUER) {
+		  auto &state = m_participants[id].state;
+		  auto *state_ptr = protect(state, HAZARD_STATE);
+		  // The dequeuer returns only after the head has moved past its node, thus the state is the one of this dequeue
+		  if (first == m_head.load() && state_ptr->pending()) {
+			  auto *done = new OperationDescription{state_ptr->phase(), false, Operation::dequeue, state_ptr->node()};
+			  if (state.compare_exchange_strong(state_ptr, done)) {
+				  retire_description(state_ptr);
+				  clear_pending(id);
+			  } else {
+				  discard_description(done);
+			  }
+		  }
+	  }
+	  // The head never passes the tail
+	  if (first == m_tail.load()) {
+		  help_finish_enqueue();
+	  }
+	  (void) m_head.compare_exchange_strong(first, next);
+  }
+
+  void count_dequeue (const Node &node) {
+	  m_participants[node.enqueuer_id()].dequeued.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Protects the dummy head and its successor, which is empty if the queue is
+  /// \details A head which has been dequeued in the meantime may have its next cleared or already reclaimed, thus the pair
+  /// 		  is only returned once the head is confirmed to be current.
+  auto protect_front () const -> std::pair<Node *, Node *> {
+	  while (true) {
+		  auto *head = protect(m_head, HAZARD_NODE);
+		  auto *next = protect(head->next(), HAZARD_NEXT);
+		  if (head == m_head.load()) { return {head, next}; }
+	  }
+  }
+
+  /// \brief Called once by the dequeuer of the element of the node and once by the dequeuer for which the node was the
+  /// 		 dummy head. The second call retires the node. The sentinel holds no element, thus it is never retired.
+  void release_node (Node *node) {
+	  if (node->release()) { telamon_simulator::hazard_pointers::HazardPointerDomain::global().retire(node); }
+  }
+
+  /// \brief Retires a description which has been replaced in the state of its participant (heap mode only)
+  void retire_description (OperationDescription *description) {
+	  if constexpr (!PREALLOCATED) {
+		  if (description != m_empty.get()) {
+			  telamon_simulator::hazard_pointers::HazardPointerDomain::global().retire(description);
+		  }
+	  }
+  }
+
+  /// \brief Frees a description which lost its CAS and thus was never shared (heap mode only)
+  void discard_description (OperationDescription *description) {
+	  if constexpr (!PREALLOCATED) { delete description; }
+  }
+
+  /// \brief Help the pending enqueues which are not later than `helper_phase`. Only the enqueuers whose bit is set in the
+  /// 		 pending bitmap are looked at.
+  void help_others (Phase helper_phase) {
+	  const auto num_words = (m_participants.size() + WORD_BITS - 1) / WORD_BITS;
+	  for (std::size_t w = 0; w < num_words; ++w) {
+		  for (auto bits = m_pending[w].load(); bits != 0; bits &= bits - 1) {
+			  const auto i = w * WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits));
+			  // Only a hint: help_enqueue validates the state under protection
+			  auto state = protect(m_participants[i].state, HAZARD_SCAN);
+			  if (state->pending() && state->phase() <= helper_phase) {
+				  if (state->operation() == Operation::enqueue) {
+					  help_enqueue(static_cast<int>(i), helper_phase);
+				  } else if constexpr (!PREALLOCATED) {
+					  help_dequeue(static_cast<int>(i), helper_phase);
+				  }
 			  }
 		  }
-		  ++i;
 	  }
   }
 
-  [[nodiscard]] std::optional<int> max_phase () const {
-	  auto it = std::max_element(m_states.begin(), m_states.end(), [] (const auto &state1, const auto &state2) {
-		return state1.load()->phase() < state2.load()->phase();
+  void mark_pending (const int enqueuer) {
+	  m_pending[enqueuer / WORD_BITS].fetch_or(uint64_t{1} << (enqueuer % WORD_BITS));
+  }
+
+  /// \brief Clear the bit of an enqueuer whose operation has just been completed
+  /// \details The enqueuer may have started its next enqueue in the meantime. Its bit is then set again, since the enqueuer
+  /// 		  publishes its state before setting the bit.
+  void clear_pending (const int enqueuer) {
+	  m_pending[enqueuer / WORD_BITS].fetch_and(~(uint64_t{1} << (enqueuer % WORD_BITS)));
+	  if (protect(m_participants[enqueuer].state, HAZARD_SCAN)->pending()) { mark_pending(enqueuer); }
+  }
+
+  /// \brief Loads a shared pointer and protects the pointee from being recycled (preallocated mode) or reclaimed (heap mode)
+  template<typename P>
+  auto protect (const std::atomic<P *> &src, const int hazard_slot) const -> P * {
+	  return telamon_simulator::hazard_pointers::HazardPointerDomain::global().protect(src, hazard_slot);
+  }
+
+  void clear_hazards () const {
+	  auto &domain = telamon_simulator::hazard_pointers::HazardPointerDomain::global();
+	  for (const int hazard_slot : {HAZARD_NODE, HAZARD_NEXT, HAZARD_STATE, HAZARD_SCAN}) {
+		  domain.clear(hazard_slot);
+	  }
+  }
+
+  /// \brief The state of an enqueuer. Registers the enqueuer if this is its first operation.
+  auto participant (const int enqueuer) -> Participant & {
+	  return m_participants.ensure(enqueuer, [this] (Participant &fresh) {
+		fresh.state.store(m_empty.get());
+		for (auto &slot : fresh.ring) {
+			slot.node.mark_dequeued(); //< Never enqueued, thus free
+		}
 	  });
-	  if (it != m_states.end()) {
-		  return it->load()->phase();
+  }
+
+  /// \brief Finds a free slot in the ring of the enqueuer. Only called by the enqueuer itself.
+  auto acquire_slot (Participant &self) -> Slot * {
+	  auto &cursor = self.cursor;
+	  for (int i = 0; i < Storage::RING_SIZE; ++i) {
+		  auto *slot = &self.ring[(cursor + i) % Storage::RING_SIZE];
+		  if (is_recyclable(self, *slot)) {
+			  cursor = (cursor + i + 1) % Storage::RING_SIZE;
+			  return slot;
+		  }
+	  }
+	  for (auto &slot : self.overflow) {
+		  if (is_recyclable(self, *slot)) { return slot.get(); }
 	  }
-	  return {};
+#ifdef TEL_LOGGING
+	  LOG_S(WARNING) << "Thread '" << current_thread_id << "': Every preallocated slot is in use. Allocating a new one.\n";
+#endif
+	  return self.overflow.emplace_back(std::make_unique<Slot>()).get();
+  }
+
+  [[nodiscard]] auto is_recyclable (const Participant &self, const Slot &slot) const -> bool {
+	  if (!slot.node.is_dequeued()) { return false; }
+	  const auto *state = self.state.load();
+	  if (state == &slot.pending || state == &slot.done) { return false; }
+	  return !telamon_simulator::hazard_pointers::HazardPointerDomain::global().is_protected(&slot.node, &slot.pending, &slot.done);
   }
 
  private:
-  std::atomic<Node *> m_head;
-  std::atomic<Node *> m_tail;
-  std::array<std::atomic<OperationDescription *>, N> m_states;
+  /// Hazard slots used by the queue. The lower ones are used by VersionedAtomic.
+  constexpr static inline int HAZARD_NODE = telamon_simulator::hazard_pointers::HazardPointerDomain::ROTATING_SLOTS;
+  constexpr static inline int HAZARD_NEXT = HAZARD_NODE + 1;
+  constexpr static inline int HAZARD_STATE = HAZARD_NODE + 2;
+  constexpr static inline int HAZARD_SCAN = HAZARD_NODE + 3;
+  static_assert(HAZARD_SCAN < telamon_simulator::hazard_pointers::HazardPointerDomain::SLOTS_PER_RECORD);
+
+  /// The dequeuer of a node which has not been claimed, and of a node claimed by `try_pop_front`
+  constexpr static inline int NO_DEQUEUER = -1;
+  constexpr static inline int CONDITIONAL_DEQUEUER = -2;
+
+ private:
+  /// The dummy head of the empty queue and the state of the enqueuers which have not enqueued yet. Owned by every queue,
+  /// so that independent queues of the same type neither link their nodes to one sentinel nor contend on it.
+  const std::unique_ptr<Node> m_sentinel = std::make_unique<Node>();
+  const std::unique_ptr<OperationDescription> m_empty = std::make_unique<OperationDescription>();
+  alignas(ALIGNMENT_OF<std::atomic<Node *>>) std::atomic<Node *> m_head;
+  alignas(ALIGNMENT_OF<std::atomic<Node *>>) std::atomic<Node *> m_tail;
+  /// The phase of the next enqueue. Claiming it costs a single fetch_add, no matter how many enqueuers have registered.
+  alignas(ALIGNMENT_OF<std::atomic<Phase>>) std::atomic<Phase> m_phase{0};
+  telamon_simulator::SegmentedArray<Participant, N> m_participants;
+  constexpr static inline std::size_t WORD_BITS = 64;
+  /// Bit i is set while enqueuer i may have a pending operation. Set by the enqueuer, cleared by whoever completes it.
+  alignas(ALIGNMENT_OF<std::atomic<uint64_t>>)
+  std::array<std::atomic<uint64_t>, (decltype(m_participants)::CAPACITY + WORD_BITS - 1) / WORD_BITS> m_pending{};
 };
 
 ///
 /// \brief The class which represents a node element of the queue
 ///
-template<typename T, const int N>
-struct HelpQueue<T, N>::Node {
+template<typename T, const int N, typename Storage, typename Layout>
+struct HelpQueue<T, N, Storage, Layout>::Node {
  public:
   /// Default construction of sentitel node
   Node () : m_is_sentitel{true} {}
@@ -302,7 +594,7 @@ struct HelpQueue<T, N>::Node {
 
   /// Construction of node with copyable data
   Node (T data, int enqueuer)
-	  : m_data{data}, m_enqueuer_id{enqueuer}, m_next(nullptr) {}
+	  : m_data{std::move(data)}, m_enqueuer_id{enqueuer}, m_next(nullptr) {}
 
   bool operator== (const Node &rhs) const {
 	  return std::tie(m_is_sentitel, m_data, m_next, m_enqueuer_id) ==
@@ -318,24 +610,68 @@ struct HelpQueue<T, N>::Node {
 
   [[nodiscard]] const T &data () const { return m_data.value(); }
 
+  /// \brief The element for its dequeuer. Only moved out of the node if it cannot be copied, since otherwise `peek_front`
+  /// 		 may still be reading it.
+  [[nodiscard]] T take_data () {
+	  if constexpr (std::is_copy_constructible_v<T>) {
+		  return m_data.value();
+	  } else {
+		  return std::move(m_data).value();
+	  }
+  }
+
   [[nodiscard]] std::atomic<Node *> &next () { return m_next; }
 
   void set_next (Node *ptr) { m_next.store(ptr); }
 
   [[nodiscard]] int enqueuer_id () const { return m_enqueuer_id; }
 
-  const inline static auto SENTITEL_NODE = std::make_unique<Node>();
+  [[nodiscard]] bool is_dequeued () const { return m_dequeued.load(); }
+
+  void mark_dequeued () { m_dequeued.store(true); }
+
+  [[nodiscard]] int dequeuer () const { return m_dequeuer.load(); }
+
+  /// \brief Claims the node as the dummy head removed by the given dequeuer
+  /// \return Whether the node was claimed by this call or, for the id of a thread, already before by the same dequeuer.
+  /// 		  Every `try_pop_front` claims with the same id, thus only the call which claimed the node dequeues it.
+  bool claim (int dequeuer) {
+	  auto expected = NO_DEQUEUER;
+	  return m_dequeuer.compare_exchange_strong(expected, dequeuer)
+		  || (dequeuer != CONDITIONAL_DEQUEUER && expected == dequeuer);
+  }
+
+  /// \brief Records that one of the two dequeues which use the node is done with it
+  /// \return Whether this was the second one
+  bool release () { return m_releases.fetch_add(1) == 1; }
+
+  /// \brief The slot which contains the node (preallocated mode only)
+  [[nodiscard]] Slot *slot () const { return m_slot; }
+
+  /// \brief Prepares a recycled node for being enqueued again. The node must not be reachable by any other thread.
+  void reset (T data, int enqueuer, Slot *t_slot) {
+	  m_data = std::move(data);
+	  m_enqueuer_id = enqueuer;
+	  m_slot = t_slot;
+	  m_next.store(nullptr);
+	  m_dequeued.store(false);
+	  m_dequeuer.store(NO_DEQUEUER);
+  }
 
  private:
   const bool m_is_sentitel = false;
   std::optional<T> m_data{};
   std::atomic<Node *> m_next;
-  const int m_enqueuer_id{-1};
+  int m_enqueuer_id{-1};
+  std::atomic<bool> m_dequeued{false};
+  std::atomic<int> m_dequeuer{NO_DEQUEUER};
+  std::atomic<int> m_releases{0};
+  Slot *m_slot{nullptr};
 };
 
 /// \brief Operation description for the queue used when the queue itself needs "helping"
-template<typename T, const int N>
-struct HelpQueue<T, N>::OperationDescription {
+template<typename T, const int N, typename Storage, typename Layout>
+struct HelpQueue<T, N, Storage, Layout>::OperationDescription {
  public:
   ///
   /// Empty construction
@@ -343,27 +679,65 @@ struct HelpQueue<T, N>::OperationDescription {
 
   ///
   /// Default construction
-  constexpr OperationDescription (int phase, bool pending, Operation operation, Node *node)
+  constexpr OperationDescription (Phase phase, bool pending, Operation operation, Node *node)
 	  : m_phase{phase},
 	    m_pending{pending},
 	    m_operation{operation},
 	    m_node{node} {}
 
+  OperationDescription (const OperationDescription &rhs)
+	  : m_is_empty{rhs.m_is_empty},
+	    m_pending{rhs.pending()},
+	    m_operation{rhs.m_operation},
+	    m_node{rhs.m_node},
+	    m_phase{rhs.phase()} {}
+
+  /// \brief Used when a preallocated description is recycled
+  auto operator= (const OperationDescription &rhs) -> OperationDescription & {
+	  m_is_empty = rhs.m_is_empty;
+	  m_pending.store(rhs.pending(), std::memory_order_relaxed);
+	  m_operation = rhs.m_operation;
+	  m_node = rhs.m_node;
+	  m_phase.store(rhs.phase(), std::memory_order_relaxed);
+	  return *this;
+  }
+
  public:
   [[nodiscard]] bool is_empty () const { return m_is_empty; }
-  [[nodiscard]] bool pending () const { return m_pending; }
+  [[nodiscard]] bool pending () const { return m_pending.load(std::memory_order_relaxed); }
   [[nodiscard]] Operation operation () const { return m_operation; }
   [[nodiscard]] Node *node () { return m_node; }
-  [[nodiscard]] int phase () const { return m_phase; }
-
-  const inline static auto EMPTY = std::make_unique<OperationDescription>();
+  [[nodiscard]] Phase phase () const { return m_phase.load(std::memory_order_relaxed); }
 
  private:
   bool m_is_empty = false;
-  bool m_pending{};
+  /// Atomic because the help queue scans descriptions which may be concurrently recycled (preallocated mode)
+  std::atomic<bool> m_pending{};
   Operation m_operation{};
-  Node *m_node;
-  int m_phase;
+  Node *m_node{nullptr};
+  std::atomic<Phase> m_phase{-1};
+};
+
+/// \brief A preallocated node together with the descriptions of its enqueue operation before and after it is linked
+template<typename T, const int N, typename Storage, typename Layout>
+struct HelpQueue<T, N, Storage, Layout>::Slot {
+  Node node{-1};
+  OperationDescription pending{};
+  OperationDescription done{};
+};
+
+/// \brief The state of a single enqueuer together with its preallocated slots (none in heap mode)
+template<typename T, const int N, typename Storage, typename Layout>
+struct HelpQueue<T, N, Storage, Layout>::Participant {
+  /// Aligned according to the layout, which pads the whole participant
+  alignas(ALIGNMENT_OF<std::atomic<OperationDescription *>>) std::atomic<OperationDescription *> state{nullptr};
+  std::array<Slot, Storage::RING_SIZE> ring{};
+  /// Only accessed by the enqueuer itself
+  int cursor{0};
+  std::vector<std::unique_ptr<Slot>> overflow{};
+  /// The elements of the enqueuer which have been enqueued, counted by the enqueuer, and dequeued, counted by the dequeuers
+  std::atomic<int64_t> enqueued{0};
+  std::atomic<int64_t> dequeued{0};
 };
 
 }  // namespace helpqueue
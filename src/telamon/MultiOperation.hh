@@ -0,0 +1,216 @@
+#ifndef TELAMON_MULTI_OPERATION_HH
+#define TELAMON_MULTI_OPERATION_HH
+
+//! \file 		MultiOperation.hh
+//! \brief 		Definitions of MultiOperation, MultiCommit and TaggedCas
+//! \details 	MultiOperation combines several normalized operations on the same structure (e.g. insert and remove) into a
+//! 			single NormalizedRepresentation. Its input, output and commit are tagged with the index of the operation they
+//! 			belong to, thus a single simulator, help queue and set of handle ids serve all of the operations and the
+//! 			helpers assist any pending operation on the structure.
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <nonstd/expected.hpp>
+
+#include "NormalizedRepresentation.hh"
+
+namespace telamon_simulator {
+
+/// \brief A reference to a CAS descriptor of one of several types. Forwards the CasWithVersioning interface to it.
+template<typename ...Cas>
+class TaggedCas {
+ public:
+  template<std::size_t I, typename T>
+  TaggedCas (std::in_place_index_t<I> index, T *cas) : m_cas{index, cas} {}
+
+ public:
+  [[nodiscard]] auto has_modified_bit () const noexcept -> bool {
+	  return std::visit([] (auto *cas) -> bool { return cas->has_modified_bit(); }, m_cas);
+  }
+
+  auto clear_bit () noexcept {
+	  std::visit([] (auto *cas) { cas->clear_bit(); }, m_cas);
+  }
+
+  [[nodiscard]] auto state () const noexcept -> CasStatus {
+	  return std::visit([] (auto *cas) -> CasStatus { return cas->state(); }, m_cas);
+  }
+
+  auto set_state (CasStatus new_state) noexcept {
+	  std::visit([&] (auto *cas) { cas->set_state(new_state); }, m_cas);
+  }
+
+  [[nodiscard]] auto swap_state (CasStatus expected, CasStatus desired) noexcept -> bool {
+	  return std::visit([&] (auto *cas) -> bool { return cas->swap_state(expected, desired); }, m_cas);
+  }
+
+  [[nodiscard]] auto execute (ContentionFailureCounter &failures) noexcept -> nonstd::expected<bool, std::monostate> {
+	  return std::visit([&] (auto *cas) -> nonstd::expected<bool, std::monostate> { return cas->execute(failures); }, m_cas);
+  }
+
+ private:
+  std::variant<Cas *...> m_cas;
+};
+
+/// \brief The commit of a MultiOperation. Holds the commit of the operation it was generated by and iterates over its CAS-es.
+/// \note  The references to the CAS-es point inside the commit, so they are rebound whenever it is copied
+template<Commits ...Commit>
+class MultiCommit {
+ public:
+  using Cas = TaggedCas<std::ranges::range_value_t<Commit>...>;
+
+ public:
+  template<std::size_t I, typename C>
+  MultiCommit (std::in_place_index_t<I> index, C &&commit) : m_commit{index, std::forward<C>(commit)} { bind(); }
+
+  MultiCommit (const MultiCommit &rhs) : m_commit{rhs.m_commit} { bind(); }
+
+  MultiCommit (MultiCommit &&rhs) noexcept(std::is_nothrow_move_constructible_v<std::variant<Commit...>>)
+	  : m_commit{std::move(rhs.m_commit)} { bind(); }
+
+  auto operator= (const MultiCommit &rhs) -> MultiCommit & {
+	  if (this != &rhs) {
+		  m_commit = rhs.m_commit;
+		  bind();
+	  }
+	  return *this;
+  }
+
+ public:
+  [[nodiscard]] auto begin () noexcept { return m_cas.begin(); }
+  [[nodiscard]] auto end () noexcept { return m_cas.end(); }
+  [[nodiscard]] auto begin () const noexcept { return m_cas.begin(); }
+  [[nodiscard]] auto end () const noexcept { return m_cas.end(); }
+
+  /// \brief The index of the operation which generated the commit
+  [[nodiscard]] auto index () const noexcept -> std::size_t { return m_commit.index(); }
+
+  /// \brief The commit of the operation with index I
+  template<std::size_t I>
+  [[nodiscard]] auto get () const -> const auto & { return std::get<I>(m_commit); }
+
+ private:
+  void bind () {
+	  m_cas.clear();
+	  std::visit([&] <typename C> (C &commit) {
+		constexpr auto I = index_of_commit<C>();
+		for (auto &cas : commit) {
+			m_cas.emplace_back(std::in_place_index<I>, &cas);
+		}
+	  }, m_commit);
+  }
+
+  /// \brief Resolves the alternative of m_commit currently being visited. Identical commit types share a CAS type, so the
+  /// 		 first matching index is as good as any.
+  template<typename C>
+  constexpr static auto index_of_commit () -> std::size_t {
+	  constexpr bool matches[] = {std::is_same_v<C, Commit>...};
+	  for (std::size_t i = 0; i < sizeof...(Commit); ++i) {
+		  if (matches[i]) { return i; }
+	  }
+	  return sizeof...(Commit);
+  }
+
+ private:
+  std::variant<Commit...> m_commit;
+  std::vector<Cas> m_cas;
+};
+
+/// \brief A normalized representation which combines the operations `Ops` of a single structure
+/// \details The input and output are variants whose active index selects the operation. Use `make_input` to construct an input
+/// 		 and `output_of` to read an output, since several operations usually share the same input and output types.
+template<NormalizedRepresentation ...Ops>
+class MultiOperation {
+  static_assert(sizeof...(Ops) > 0, "At least a single operation is required.");
+
+ public:
+  using Input = std::variant<typename Ops::Input...>;
+  using Output = std::variant<typename Ops::Output...>;
+  using Commit = MultiCommit<typename Ops::Commit...>;
+
+  /// The index of operation Op in the pack
+  template<typename Op>
+  constexpr static inline std::size_t index_of = [] {
+	  constexpr bool matches[] = {std::is_same_v<Op, Ops>...};
+	  std::size_t index = sizeof...(Ops);
+	  for (std::size_t i = 0; i < sizeof...(Ops); ++i) {
+		  if (matches[i]) {
+			  if (index != sizeof...(Ops)) { return sizeof...(Ops); }   //< Ambiguous
+			  index = i;
+		  }
+	  }
+	  return index;
+  }();
+
+ public:
+  explicit MultiOperation (Ops... ops) : m_ops{std::move(ops)...} {}
+
+  template<typename Op>
+  static auto make_input (typename Op::Input input) -> Input {
+	  static_assert(index_of<Op> < sizeof...(Ops), "Op has to appear exactly once among the operations.");
+	  return Input{std::in_place_index<index_of<Op>>, std::move(input)};
+  }
+
+  template<typename Op>
+  static auto output_of (const Output &output) -> const typename Op::Output & {
+	  static_assert(index_of<Op> < sizeof...(Ops), "Op has to appear exactly once among the operations.");
+	  return std::get<index_of<Op>>(output);
+  }
+
+ public:
+  auto generator (const Input &inp, ContentionFailureCounter &failures) -> std::optional<Commit> {
+	  return dispatch(inp.index(), [&] <std::size_t I> (std::integral_constant<std::size_t, I>) -> std::optional<Commit> {
+		auto commit = std::get<I>(m_ops).generator(std::get<I>(inp), failures);
+		if (!commit.has_value()) { return std::nullopt; }
+		return std::make_optional<Commit>(std::in_place_index<I>, std::move(commit.value()));
+	  });
+  }
+
+  auto wrap_up (const nonstd::expected<std::monostate, std::optional<int>> &executed, const Commit &desc, ContentionFailureCounter &failures)
+  -> nonstd::expected<std::optional<Output>, std::monostate> {
+	  using Result = nonstd::expected<std::optional<Output>, std::monostate>;
+	  return dispatch(desc.index(), [&] <std::size_t I> (std::integral_constant<std::size_t, I>) -> Result {
+		auto result = std::get<I>(m_ops).wrap_up(executed, desc.template get<I>(), failures);
+		if (!result.has_value()) { return nonstd::make_unexpected(std::monostate{}); }
+		if (!result.value().has_value()) { return std::optional<Output>{}; }
+		return std::make_optional<Output>(std::in_place_index<I>, std::move(result.value().value()));
+	  });
+  }
+
+  auto fast_path (const Input &inp, ContentionFailureCounter &failures) -> std::optional<Output> {
+	  return dispatch(inp.index(), [&] <std::size_t I> (std::integral_constant<std::size_t, I>) -> std::optional<Output> {
+		auto output = std::get<I>(m_ops).fast_path(std::get<I>(inp), failures);
+		if (!output.has_value()) { return std::nullopt; }
+		return std::make_optional<Output>(std::in_place_index<I>, std::move(output.value()));
+	  });
+  }
+
+ private:
+  /// \brief Invoke `fun` with the index of the operation as a compile-time constant
+  template<typename Fun>
+  static auto dispatch (const std::size_t index, Fun &&fun) {
+	  return dispatch(index, std::forward<Fun>(fun), std::index_sequence_for<Ops...>{});
+  }
+
+  template<typename Fun, std::size_t ...Is>
+  static auto dispatch (const std::size_t index, Fun &&fun, std::index_sequence<Is...>) {
+	  using Result = decltype(fun(std::integral_constant<std::size_t, 0>{}));
+	  std::optional<Result> result;
+	  (void) ((index == Is && (result.emplace(fun(std::integral_constant<std::size_t, Is>{})), true)) || ...);
+	  return std::move(result.value());
+  }
+
+ private:
+  std::tuple<Ops...> m_ops;
+};
+
+}
+
+#endif // TELAMON_MULTI_OPERATION_HH
@@ -16,6 +16,7 @@
 #include <utility>
 #include <iterator>
 #include <optional>
+#include <tuple>
 
 #include <nonstd/expected.hpp>
 
@@ -32,6 +33,13 @@ concept Commits = requires (Commit desc) {
 	requires CasWithVersioning<std::ranges::range_value_t<Commit>>;
 };
 
+/// \brief Commits whose number of CAS-es is known at compile time, such as std::array. The simulator commits them with an
+/// 	   unrolled loop (see WaitFreeSimulator::commit).
+template<typename Commit>
+concept FixedSizeCommits = Commits<Commit> && requires {
+	{ std::tuple_size<Commit>::value } -> std::convertible_to<std::size_t>;
+};
+
 /// \brief   Here are the operations which are required to be described in the lock-free algorithm in order to use the
 /// 	     simulation. There are 3 types which the lock-free has to define according to its specifics as well as 3 functions.
 /// \tparam  LockFree The lock-free algorithm which is being simulated
@@ -1,11 +1,17 @@
 #ifndef TELAMON_OPERATION_HELPING_HH
 #define TELAMON_OPERATION_HELPING_HH
 
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
 #include <thread>
 #include <variant>
 #include <utility>
 
 #include "NormalizedRepresentation.hh"
+#include "ContentionPolicy.hh"
 
 namespace telamon_simulator {
 
@@ -16,6 +22,10 @@ class OperationRecord {
   using Input = typename LockFree::Input;
   using Commit = typename LockFree::Commit;
  public:
+  /// \brief The CAS-list of an attempt. Shared by the ExecutingCas and PostCas records of the attempt, thus state transitions
+  /// 		 do not copy it. Only the statuses of the CAS-es inside change after it is generated.
+  using SharedCommit = std::shared_ptr<Commit>;
+
   /// \brief Meta data related to CAS which is still pending
   struct PreCas {
 	PreCas () = default;
@@ -23,16 +33,17 @@ class OperationRecord {
   };
   /// \brief Meta data related to CAS which is going to be executed
   struct ExecutingCas {
-	Commit cas_list;
-	explicit ExecutingCas (Commit t_cas_list) : cas_list{std::move(t_cas_list)} {}
+	SharedCommit cas_list;
+	explicit ExecutingCas (Commit t_cas_list) : cas_list{std::make_shared<Commit>(std::move(t_cas_list))} {}
 	ExecutingCas (const ExecutingCas &) = default;
   };
   /// \brief Meta data related to CAS which has already been executed
   struct PostCas {
-	Commit cas_list;
+	SharedCommit cas_list;
 	nonstd::expected<std::monostate, std::optional<int>> executed;
-	PostCas (Commit t_cas_list, nonstd::expected<std::monostate, std::optional<int>> t_executed) : cas_list{t_cas_list},
-	                                                                                               executed{std::move(t_executed)} {}
+	PostCas (SharedCommit t_cas_list, nonstd::expected<std::monostate, std::optional<int>> t_executed)
+		: cas_list{std::move(t_cas_list)},
+		  executed{std::move(t_executed)} {}
 	PostCas (const PostCas &) = default;
   };
   /// \brief Meta data related to CAS which is complete.
@@ -67,7 +78,9 @@ class OperationRecord {
 
  public:
   [[nodiscard]] auto owner () const noexcept -> int { return m_owner; }
-  [[nodiscard]] auto state () const noexcept -> OperationState { return m_state; }
+  /// \brief The state of the operation. Valid for as long as the record is, i.e. while the reader is protected from its
+  /// 		 reclamation.
+  [[nodiscard]] auto state () const noexcept -> const OperationState & { return m_state; }
   [[nodiscard]] auto input () const noexcept -> const typename LockFree::Input & { return m_input; }
 
   [[maybe_unused]] void set_state (const OperationState &t_state) noexcept { m_state = t_state; }
@@ -80,9 +93,17 @@ class OperationRecord {
   static_assert(std::is_copy_constructible_v<OperationState>);
 };
 
+/// \brief A coroutine which waits for an operation on the slow-path. Handed over to the owner of the operation once it completes.
+struct SuspendedOperation {
+  std::coroutine_handle<> coroutine{};
+  SuspendedOperation *next{nullptr};
+};
+
 /// \brief A class which represents a single operation stored in the help queue
+/// \details Aligned to a cache line, so that the boxes of different owners, which are allocated one after the other, do not
+/// 		  share one. Every helper reads the record pointer of a box while its owner polls and parks on it.
 template<typename LockFree> requires NormalizedRepresentation<LockFree>
-class OperationRecordBox {
+class alignas(64) OperationRecordBox {
  public:
   OperationRecordBox (int t_owner, typename OperationRecord<LockFree>::OperationState t_state, const typename LockFree::Input &t_input)
 	  : m_ptr{new OperationRecord<LockFree>{t_owner, t_state, t_input}} {}
@@ -98,7 +119,8 @@ class OperationRecordBox {
 	  return !(rhs == *this);
   }
 
-  [[nodiscard]] auto state() const noexcept -> typename OperationRecord<LockFree>::OperationState { return m_ptr.load()->state(); }
+  /// \copydoc OperationRecord::state
+  [[nodiscard]] auto state () const noexcept -> const typename OperationRecord<LockFree>::OperationState & { return m_ptr.load()->state(); }
 
   [[nodiscard]] auto ptr () const noexcept -> OperationRecord<LockFree> * { return m_ptr.load(); }
 
@@ -106,6 +128,33 @@ class OperationRecordBox {
 
   [[maybe_unused]] auto nonatomic_ptr () const noexcept -> OperationRecord<LockFree> * { return m_ptr; }
 
+  /// \brief Register a coroutine waiting for the operation
+  /// \return False if the operation has already completed, in which case the coroutine should not be suspended
+  auto attach_waiter (SuspendedOperation *waiter) noexcept -> bool {
+	  SuspendedOperation *expected = nullptr;
+	  return m_waiter.compare_exchange_strong(expected, waiter);
+  }
+
+  /// \brief Mark the operation as completed. Called once by the helper which completed it.
+  /// \return The coroutine registered until then (if any)
+  auto detach_waiter () noexcept -> SuspendedOperation * {
+	  auto *waiter = m_waiter.exchange(&COMPLETED);
+	  return waiter == &COMPLETED ? nullptr : waiter;
+  }
+
+  /// \brief Park the owner until the operation is completed or `timeout` passes. Only called by the owner.
+  void park_owner (const std::chrono::microseconds timeout) noexcept {
+	  auto expected = m_completion.load();
+	  if (expected == PENDING && !m_completion.compare_exchange_strong(expected, PARKED)) { return; }   //< Just completed
+	  if (expected == COMPLETED_FLAG) { return; }
+	  park(m_completion, PARKED, timeout);
+  }
+
+  /// \brief Wake the owner if it is parked. Called once by the helper which completed the operation.
+  void notify_completed () noexcept {
+	  if (m_completion.exchange(COMPLETED_FLAG) == PARKED) { unpark(m_completion); }
+  }
+
   /// \brief Atomically swaps the pointer m_ptr with pointer the given box record
   auto swap (OperationRecordBox desired, OperationRecordBox *expected_ptr) -> bool {
 	  auto desired_ptr = new OperationRecord{std::move(desired)};        //< TODO: Use folly/Hazptr
@@ -115,6 +164,17 @@ class OperationRecordBox {
  private:
   // TODO: Use folly/Hazptr
   std::atomic<OperationRecord<LockFree> *> m_ptr;
+  /// Either empty, the waiting coroutine or COMPLETED
+  std::atomic<SuspendedOperation *> m_waiter{nullptr};
+
+  constexpr static inline uint32_t PENDING = 0;
+  constexpr static inline uint32_t PARKED = 1;
+  constexpr static inline uint32_t COMPLETED_FLAG = 2;
+  /// The word the owner parks on (see park_owner)
+  std::atomic<uint32_t> m_completion{PENDING};
+
+  /// Marks a box whose waiter has already been handed over
+  inline static SuspendedOperation COMPLETED{};
 };
 
 }
@@ -0,0 +1,99 @@
+#ifndef TELAMON_SEGMENTED_ARRAY_HH
+#define TELAMON_SEGMENTED_ARRAY_HH
+
+//! \file 		SegmentedArray.hh
+//! \brief 		Definition of SegmentedArray
+//! \details 	Used for the per-participant state of the help queue, the epoch domain and the simulator, so that participants
+//! 			can register at runtime beyond the compile-time N. Elements never move once created and scans only cover the
+//! 			participants which have registered so far.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace telamon_simulator {
+
+/// \brief A lock-free array which grows by segments of SegmentSize elements up to MaxSegments segments
+/// \details Segments are allocated on first use of any of their elements and freed only together with the array. `size` is
+/// 		 one past the highest index which has been ensured, thus loops up to it cost proportionally to the number of
+/// 		 registered participants rather than to the capacity.
+template<typename T, std::size_t SegmentSize, std::size_t MaxSegments = 64>
+class SegmentedArray {
+  static_assert(SegmentSize > 0 && MaxSegments > 0);
+
+ public:
+  constexpr static inline std::size_t CAPACITY = SegmentSize * MaxSegments;
+
+ public:
+  SegmentedArray () = default;
+  SegmentedArray (const SegmentedArray &) = delete;
+  auto operator= (const SegmentedArray &) -> SegmentedArray & = delete;
+
+  ~SegmentedArray () {
+	  for (auto &segment : m_segments) { delete[] segment.load(); }
+  }
+
+ public:
+  /// \brief Make sure the element at `index` exists and is covered by `size`
+  /// \param init Called on every element of a newly allocated segment before the segment becomes visible to other threads
+  /// \note  Throws std::out_of_range if `index` is not below CAPACITY, just like std::array::at
+  template<typename Init>
+  auto ensure (const std::size_t index, Init &&init) -> T & {
+	  auto &segment = m_segments.at(index / SegmentSize);
+	  auto *elements = segment.load(std::memory_order_acquire);
+	  if (!elements) {
+		  auto *fresh = new T[SegmentSize];
+		  for (std::size_t i = 0; i < SegmentSize; ++i) { init(fresh[i]); }
+		  if (segment.compare_exchange_strong(elements, fresh)) {
+			  elements = fresh;
+		  } else {
+			  delete[] fresh;    //< Another thread allocated the segment first
+		  }
+	  }
+
+	  auto size = m_size.load(std::memory_order_relaxed);
+	  while (size <= index && !m_size.compare_exchange_weak(size, index + 1)) {}
+	  return elements[index % SegmentSize];
+  }
+
+  auto ensure (const std::size_t index) -> T & { return ensure(index, [] (T &) {}); }
+
+  /// \brief Access an element which has already been ensured (or belongs to a segment which has been allocated)
+  auto operator[] (const std::size_t index) noexcept -> T & {
+	  return m_segments[index / SegmentSize].load(std::memory_order_acquire)[index % SegmentSize];
+  }
+
+  auto operator[] (const std::size_t index) const noexcept -> const T & {
+	  return m_segments[index / SegmentSize].load(std::memory_order_acquire)[index % SegmentSize];
+  }
+
+  /// \brief Whether the element at `index` can be accessed, i.e. its segment has been allocated
+  [[nodiscard]] auto contains (const std::size_t index) const noexcept -> bool {
+	  return index < CAPACITY && m_segments[index / SegmentSize].load(std::memory_order_acquire) != nullptr;
+  }
+
+  /// \brief One past the highest index which has been ensured
+  [[nodiscard]] auto size () const noexcept -> std::size_t { return m_size.load(); }
+
+  /// \brief Call `fun(index, element)` for every element below `size`. Segments which were skipped over are not allocated.
+  template<typename Fun>
+  void for_each (Fun &&fun) const {
+	  const auto size_ = size();
+	  for (std::size_t first = 0; first < size_; first += SegmentSize) {
+		  auto *elements = m_segments[first / SegmentSize].load(std::memory_order_acquire);
+		  if (!elements) { continue; }
+		  for (std::size_t i = first; i < std::min(first + SegmentSize, size_); ++i) {
+			  fun(i, elements[i - first]);
+		  }
+	  }
+  }
+
+ private:
+  std::array<std::atomic<T *>, MaxSegments> m_segments{};
+  std::atomic<std::size_t> m_size{0};
+};
+
+}
+
+#endif // TELAMON_SEGMENTED_ARRAY_HH
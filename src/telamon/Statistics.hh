@@ -0,0 +1,114 @@
+#ifndef TELAMON_STATISTICS_HH
+#define TELAMON_STATISTICS_HH
+
+//! \file 		Statistics.hh
+//! \brief 		Definitions of Statistics and StatisticsCounters
+//! \details 	When TEL_STATISTICS is defined, the simulator counts how its operations go through the fast-path and the
+//! 			slow-path. Every id has its own counters, which only the thread owning the id writes, thus counting takes
+//! 			no atomic read-modify-write and no cache line is written by several threads. Without TEL_STATISTICS nothing is
+//! 			counted and the snapshots are all zeros.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace telamon_simulator {
+
+#ifdef TEL_STATISTICS
+constexpr inline bool STATISTICS_ENABLED = true;
+#else
+constexpr inline bool STATISTICS_ENABLED = false;
+#endif
+
+/// \brief The states of an operation record in the order the helpers see them
+enum class HelpedState : std::size_t { PreCas, ExecutingCas, PostCas, Completed };
+
+/// \brief The fields of the statistics, either counters owned by a single id or plain numbers of a snapshot
+template<typename T>
+struct BasicStatistics {
+  /// The number of CAS indices which are counted separately. Failures at a higher index are counted in the last bucket.
+  constexpr static inline std::size_t COMMIT_FAILURE_BUCKETS = 8;
+
+  T fast_path_attempts{};
+  T fast_path_successes{};
+  /// The operations which went straight to the slow-path because their handle predicted the fast-path to fail
+  T fast_path_skips{};
+  /// The contention reported to the counters of the fast-path, including by the algorithm itself
+  T contention_detections{};
+  T slow_path_entries{};
+  /// Indexed by HelpedState
+  std::array<T, 4> helps{};
+  /// The CAS-es of a helper on the box of an operation which lost to another helper
+  T failed_box_cas{};
+  /// Indexed by the CAS of the commit which failed (see COMMIT_FAILURE_BUCKETS)
+  std::array<T, COMMIT_FAILURE_BUCKETS> commit_failures{};
+
+  [[nodiscard]] auto help_count (const HelpedState state) const -> const T & {
+	  return helps.at(static_cast<std::size_t>(state));
+  }
+
+  [[nodiscard]] auto commit_failure_count (const std::size_t index) const -> const T & {
+	  return commit_failures.at(std::min(index, COMMIT_FAILURE_BUCKETS - 1));
+  }
+};
+
+/// \brief A counter with a single writer. Reading it from other threads is safe, but may lag behind.
+class RelaxedCounter {
+ public:
+  RelaxedCounter () = default;
+
+  auto operator++ () noexcept -> RelaxedCounter & { return *this += 1; }
+
+  auto operator+= (const uint64_t n) noexcept -> RelaxedCounter & {
+	  m_value.store(m_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	  return *this;
+  }
+
+  [[nodiscard]] auto load () const noexcept -> uint64_t { return m_value.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+/// \brief A snapshot of the counters of one or several ids
+struct Statistics : BasicStatistics<uint64_t> {
+  auto operator+= (const Statistics &rhs) -> Statistics & {
+	  fast_path_attempts += rhs.fast_path_attempts;
+	  fast_path_successes += rhs.fast_path_successes;
+	  fast_path_skips += rhs.fast_path_skips;
+	  contention_detections += rhs.contention_detections;
+	  slow_path_entries += rhs.slow_path_entries;
+	  for (std::size_t i = 0; i < helps.size(); ++i) { helps[i] += rhs.helps[i]; }
+	  failed_box_cas += rhs.failed_box_cas;
+	  for (std::size_t i = 0; i < commit_failures.size(); ++i) { commit_failures[i] += rhs.commit_failures[i]; }
+	  return *this;
+  }
+};
+
+/// \brief The counters of a single id. Aligned to a cache line, so that the owners of neighbouring ids do not interfere.
+struct alignas(64) StatisticsCounters : BasicStatistics<RelaxedCounter> {
+  auto count_help (const HelpedState state) noexcept { ++helps[static_cast<std::size_t>(state)]; }
+
+  auto count_commit_failure (const std::size_t index) noexcept {
+	  ++commit_failures[std::min(index, COMMIT_FAILURE_BUCKETS - 1)];
+  }
+
+  [[nodiscard]] auto snapshot () const -> Statistics {
+	  auto result = Statistics{};
+	  result.fast_path_attempts = fast_path_attempts.load();
+	  result.fast_path_successes = fast_path_successes.load();
+	  result.fast_path_skips = fast_path_skips.load();
+	  result.contention_detections = contention_detections.load();
+	  result.slow_path_entries = slow_path_entries.load();
+	  for (std::size_t i = 0; i < helps.size(); ++i) { result.helps[i] = helps[i].load(); }
+	  result.failed_box_cas = failed_box_cas.load();
+	  for (std::size_t i = 0; i < commit_failures.size(); ++i) { result.commit_failures[i] = commit_failures[i].load(); }
+	  return result;
+  }
+};
+
+}
+
+#endif // TELAMON_STATISTICS_HH
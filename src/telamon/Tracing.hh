@@ -0,0 +1,291 @@
+#ifndef TELAMON_TRACING_HH
+#define TELAMON_TRACING_HH
+
+//! \file 		Tracing.hh
+//! \brief 		Definitions of TraceEvent, TraceRecorder and TraceCollector
+//! \details 	When TEL_TRACING is defined, the simulator and the help queue record compact binary events instead of formatting
+//! 			log messages. Every thread writes to its own ring buffer, which takes a clock read and a few plain stores per
+//! 			event. The buffers are drained by another thread (see TraceCollector) and the events can be exported as Chrome
+//! 			trace-event JSON, which shows the helping between the threads on a timeline. Without TEL_TRACING nothing is
+//! 			recorded.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace telamon_simulator {
+
+#ifdef TEL_TRACING
+constexpr inline bool TRACING_ENABLED = true;
+#else
+constexpr inline bool TRACING_ENABLED = false;
+#endif
+
+/// \brief This module contains the per-thread event buffers used for tracing the simulator
+namespace tracing {
+
+/// \brief What happened. The meaning of the argument of the event is given next to each kind.
+enum class TraceEventKind : uint8_t {
+  FastPathAttempt,    //< The number of the attempt
+  FastPathSucceeded,  //< The number of attempts it took
+  FastPathAbandoned,  //< The contention counted by the attempts
+  FastPathSkipped,    //< The estimate of the predictor of the handle
+  SlowPathEnqueued,
+  SlowPathCompleted,  //< Observed by the owner
+  Help,               //< The state of the helped operation (see HelpedState)
+  Transition,         //< The state the operation was moved to by the helper
+  BoxCasFailed,       //< The state the helper tried to move the operation to
+  CommitFailed,       //< The index of the failed CAS, or -1 on contention
+  QueuePush,          //< The phase of the enqueue
+  QueuePop,           //< Whether the head was dequeued
+  QueueHelpEnqueue    //< The id of the helped enqueuer
+};
+
+/// \brief A single event. The operation is identified by the address of its box (or help queue node), zero if there is none.
+struct TraceEvent {
+  /// Nanoseconds since the recorder was created
+  uint64_t timestamp;
+  uint64_t operation;
+  /// The id on whose behalf the thread acted, -1 if unknown
+  int32_t id;
+  int32_t arg;
+  /// The buffer which recorded the event. Stands for the thread in the exported trace.
+  uint16_t thread;
+  TraceEventKind kind;
+};
+
+/// \brief The name of a kind of event as shown in the exported trace
+constexpr auto name (const TraceEventKind kind) noexcept -> const char * {
+	switch (kind) {
+		case TraceEventKind::FastPathAttempt: return "FastPathAttempt";
+		case TraceEventKind::FastPathSucceeded: return "FastPathSucceeded";
+		case TraceEventKind::FastPathAbandoned: return "FastPathAbandoned";
+		case TraceEventKind::FastPathSkipped: return "FastPathSkipped";
+		case TraceEventKind::SlowPathEnqueued: return "SlowPathEnqueued";
+		case TraceEventKind::SlowPathCompleted: return "SlowPathCompleted";
+		case TraceEventKind::Help: return "Help";
+		case TraceEventKind::Transition: return "Transition";
+		case TraceEventKind::BoxCasFailed: return "BoxCasFailed";
+		case TraceEventKind::CommitFailed: return "CommitFailed";
+		case TraceEventKind::QueuePush: return "QueuePush";
+		case TraceEventKind::QueuePop: return "QueuePop";
+		case TraceEventKind::QueueHelpEnqueue: return "QueueHelpEnqueue";
+	}
+	return "Unknown";
+}
+
+/// \brief The recorder of the events of every thread. Buffers are acquired lazily by each thread and are reused after the
+/// 	   thread exits, like the records of HazardPointerDomain.
+/// \note  There is a single recorder per process (see `global`) because the buffer of a thread is cached in a thread_local.
+class TraceRecorder {
+ public:
+  /// The number of events a buffer holds before it is drained. Events recorded into a full buffer are dropped.
+  constexpr static inline std::size_t BUFFER_CAPACITY = 4096;
+
+  /// \brief A ring buffer with a single writer (the owning thread) and a single reader (whoever drains the recorder)
+  struct alignas(64) Buffer {
+	std::array<TraceEvent, BUFFER_CAPACITY> events{};
+	/// Written by the owner only
+	alignas(64) std::atomic<uint64_t> head{0};
+	std::atomic<uint64_t> dropped{0};
+	/// Written by the reader only
+	alignas(64) std::atomic<uint64_t> tail{0};
+	std::atomic<bool> in_use{false};
+	uint16_t thread{0};
+	Buffer *next{nullptr};
+  };
+
+ public:
+  TraceRecorder (const TraceRecorder &) = delete;
+  auto operator= (const TraceRecorder &) -> TraceRecorder & = delete;
+
+  ~TraceRecorder () {
+	  auto *buffer = m_buffers.load();
+	  while (buffer) {
+		  auto *next = buffer->next;
+		  delete buffer;
+		  buffer = next;
+	  }
+  }
+
+  static auto global () -> TraceRecorder & {
+	  static TraceRecorder recorder;
+	  return recorder;
+  }
+
+ public:
+  /// \brief Record an event in the buffer of the calling thread
+  void record (const TraceEventKind kind, const int id, const void *operation, const int arg = 0) noexcept {
+	  auto &buffer = attach();
+	  const auto head = buffer.head.load(std::memory_order_relaxed);
+	  if (head - buffer.tail.load(std::memory_order_acquire) == BUFFER_CAPACITY) {
+		  buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		  return;
+	  }
+	  buffer.events[head % BUFFER_CAPACITY] = TraceEvent{
+		  .timestamp = now(),
+		  .operation = reinterpret_cast<uintptr_t>(operation),
+		  .id = id,
+		  .arg = arg,
+		  .thread = buffer.thread,
+		  .kind = kind
+	  };
+	  buffer.head.store(head + 1, std::memory_order_release);
+  }
+
+  /// \brief Move the events recorded so far into `out`. The events of a thread stay in order.
+  void drain (std::vector<TraceEvent> &out) {
+	  const auto lock = std::scoped_lock{m_drain_mutex};
+	  for (auto *buffer = m_buffers.load(); buffer; buffer = buffer->next) {
+		  auto tail = buffer->tail.load(std::memory_order_relaxed);
+		  const auto head = buffer->head.load(std::memory_order_acquire);
+		  for (; tail < head; ++tail) { out.push_back(buffer->events[tail % BUFFER_CAPACITY]); }
+		  buffer->tail.store(tail, std::memory_order_release);
+	  }
+  }
+
+  /// \brief The number of events which were dropped because the buffer of their thread was full
+  [[nodiscard]] auto dropped () const -> uint64_t {
+	  uint64_t total = 0;
+	  for (auto *buffer = m_buffers.load(); buffer; buffer = buffer->next) {
+		  total += buffer->dropped.load(std::memory_order_relaxed);
+	  }
+	  return total;
+  }
+
+ private:
+  TraceRecorder () = default;
+
+  /// \brief Releases the buffer of a thread when it exits. Its remaining events are still drained.
+  struct ThreadBuffer {
+	TraceRecorder &recorder;
+	Buffer *buffer;
+	explicit ThreadBuffer (TraceRecorder &t_recorder) : recorder{t_recorder}, buffer{t_recorder.acquire()} {}
+	~ThreadBuffer () { buffer->in_use.store(false, std::memory_order_release); }
+  };
+
+  auto attach () -> Buffer & {
+	  thread_local ThreadBuffer local{*this};
+	  return *local.buffer;
+  }
+
+  auto acquire () -> Buffer * {
+	  for (auto *buffer = m_buffers.load(); buffer; buffer = buffer->next) {
+		  auto expected = false;
+		  if (!buffer->in_use.load() && buffer->in_use.compare_exchange_strong(expected, true)) {
+			  return buffer;
+		  }
+	  }
+
+	  auto *buffer = new Buffer{};
+	  buffer->in_use.store(true);
+	  buffer->thread = static_cast<uint16_t>(m_num_buffers.fetch_add(1));
+	  auto *head = m_buffers.load();
+	  do {
+		  buffer->next = head;
+	  } while (!m_buffers.compare_exchange_weak(head, buffer));
+	  return buffer;
+  }
+
+  [[nodiscard]] auto now () const noexcept -> uint64_t {
+	  const auto elapsed = std::chrono::steady_clock::now() - m_start;
+	  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+ private:
+  std::atomic<Buffer *> m_buffers{nullptr};
+  std::atomic<uint16_t> m_num_buffers{0};
+  /// Buffers have a single reader
+  std::mutex m_drain_mutex;
+  const std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+};
+
+/// \brief Record an event in the global recorder. Compiled out unless TEL_TRACING is defined.
+inline void trace (const TraceEventKind kind, const int id, const void *operation = nullptr, const int arg = 0) noexcept {
+	if constexpr (TRACING_ENABLED) {
+		TraceRecorder::global().record(kind, id, operation, arg);
+	} else {
+		(void) kind;
+		(void) id;
+		(void) operation;
+		(void) arg;
+	}
+}
+
+/// \brief Write the events in the Chrome trace-event format (as loaded by chrome://tracing or Perfetto)
+/// \details Every event is an instant event on the timeline of the thread which recorded it. The operation, the id and the
+/// 		 argument are shown as the arguments of the event.
+inline void write_chrome_trace (std::ostream &os, std::span<const TraceEvent> events) {
+	os << "{\"traceEvents\":[";
+	for (bool first = true; const auto &event : events) {
+		if (!first) { os << ','; }
+		first = false;
+		os << "\n{\"name\":\"" << name(event.kind) << "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0"
+		   << ",\"tid\":" << event.thread
+		   << ",\"ts\":" << event.timestamp / 1000 << '.' << event.timestamp % 1000 / 100 << event.timestamp % 100 / 10 << event.timestamp % 10
+		   << ",\"args\":{\"op\":" << event.operation << ",\"id\":" << event.id << ",\"arg\":" << event.arg << "}}";
+	}
+	os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+/// \brief Drains the global recorder on a background thread, so that the buffers of the traced threads do not fill up
+class TraceCollector {
+ public:
+  explicit TraceCollector (const std::chrono::milliseconds interval = std::chrono::milliseconds{1})
+	  : m_worker{[this, interval] (const std::stop_token &stop) {
+		while (!stop.stop_requested()) {
+			collect();
+			std::this_thread::sleep_for(interval);
+		}
+	  }} {}
+
+  TraceCollector (const TraceCollector &) = delete;
+  auto operator= (const TraceCollector &) -> TraceCollector & = delete;
+
+  ~TraceCollector () { stop(); }
+
+  /// \brief Stop the background thread and drain what is left
+  void stop () {
+	  if (m_worker.joinable()) {
+		  m_worker.request_stop();
+		  m_worker.join();
+	  }
+	  collect();
+  }
+
+  /// \brief The events collected so far
+  [[nodiscard]] auto events () -> std::vector<TraceEvent> {
+	  collect();
+	  const auto lock = std::scoped_lock{m_mutex};
+	  return m_events;
+  }
+
+  void write_chrome_trace (std::ostream &os) {
+	  const auto collected = events();
+	  tracing::write_chrome_trace(os, collected);
+  }
+
+ private:
+  void collect () {
+	  const auto lock = std::scoped_lock{m_mutex};
+	  TraceRecorder::global().drain(m_events);
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::vector<TraceEvent> m_events;
+  /// Declared last, so that the thread is stopped before the events are destroyed
+  std::jthread m_worker;
+};
+
+}
+}
+
+#endif // TELAMON_TRACING_HH
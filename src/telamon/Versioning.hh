@@ -2,29 +2,36 @@
 #define TELAMON_SRC_TELAMON_VERSIONING_HH_
 
 //! \file 		Versioning.hh
-//! \brief 		Definitions of ContentionFailureCounter, CasStatus, CasDescriptor, CasWithVersioning, VersionedAtomic
+//! \brief 		Definitions of CasStatus, CasDescriptor, CasWithVersioning, VersionedAtomic
 //! \details 	VersionedAtomic is used by the user to implement the required functions of CasWithVersioning,
 //! 			requirement of the NormalizedRepresentation concept
+//! \details 	The cells which are replaced by a store or a successful CAS are retired to the hazard pointer domain and reclaimed
+//! 			in batches. The cells returned by `load` are protected by a guard which owns a hazard slot of the calling thread.
+//! \details 	The representation of a VersionedAtomic is selected by its third template parameter. ReferencedCells keeps every
+//! 			version in a heap cell, InlineDoubleWord keeps value, meta and version inline in 16 bytes and PackedWord squeezes
+//! 			a pointer, a mark bit and a truncated version into a single 64-bit word.
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+#if defined(__x86_64__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+/// cmpxchg16b is available (requires -mcx16)
+#define TELAMON_HAS_DWCAS 1
+#endif
+
+#include <nonstd/expected.hpp>
+
+#include "ContentionPolicy.hh"
+#include "HazardPointers.hh"
 
 namespace telamon_simulator {
 
-/// \brief Measures the contention which was encountered during simulation
-/// \details Keeps an internal counter of the detected contention and responds according to it.
-class ContentionFailureCounter {
- public:
-  constexpr static inline int THRESHOLD = 2;
-  constexpr static inline int FAST_PATH_RETRY_THRESHOLD = 3;
-
- public:
-  auto detect () -> bool {
-	  return (++m_counter > ContentionFailureCounter::THRESHOLD);
-  }
-  [[nodiscard]] auto get () const noexcept -> int { return m_counter; }
-
- private:
-  int m_counter{0};
-};
-
 /// \brief Represents the status of a CAS primitive
 enum class CasStatus : char {
   Pending,
@@ -36,7 +43,9 @@ enum class CasStatus : char {
 /// \details 	See p.15 of the paper
 /// \tparam Cas CasDescriptor primitive
 /// \details 	About execute: Returns either a bool marking whether the CAS was executed successfully or an error marking
-///     		there was contention during the execution
+///     		there was contention during the execution. A CAS which another helper of the same commit has already performed
+///     		counts as executed successfully. False means that the CAS can no longer take effect (e.g. the expected value of
+///     		its target has been replaced by another update), thus the commit fails at it.
 template<typename Cas>
 concept CasWithVersioning = requires (Cas cas_, CasStatus status, ContentionFailureCounter &failures, CasStatus expected, CasStatus desired){
 	{ cas_.has_modified_bit() } -> std::same_as<bool>;
@@ -54,9 +63,94 @@ namespace versioning {
 /// uint_least64_t is used to guarantee (minimize) the chance of the ABA problem occurring
 using VersionNum = uint_least64_t;
 
+/// \brief Representation in which every version of the value is kept in its own heap cell (the default)
+struct ReferencedCells {};
+
+/// \brief Representation in which value, meta and version are kept inline in a single 16-byte word which is updated with a
+/// 	   double-width CAS. Only usable for small trivially copyable values and metas. The version is truncated to 48 bits.
+struct InlineDoubleWord {};
+
+/// \brief Representation in which a pointer, a one-bit meta (a mark) and a 16-bit version are kept in a single 64-bit word
+/// \details The mark takes the lowest bit of the (at least 2-aligned) pointer and the version takes the 16 high bits which
+/// 		  are unused by user-space pointers on x86-64 and AArch64 (48-bit virtual addresses).
+/// \warning The version wraps around after 65536 updates. A CAS which expects a given version may therefore succeed
+/// 		  spuriously if the link was updated a multiple of 65536 times since it was loaded and ended up holding the same
+/// 		  pointer and mark. This ABA window is acceptable for short-lived expectations (e.g. a single search followed by a
+/// 		  CAS) but not for descriptors which may stay pending for long; use ReferencedCells or InlineDoubleWord there.
+struct PackedWord {};
+
 /// \brief This module serves as a wrapper for the private data in the telamon_simulator module
 namespace telamon_private {
 
+/// \brief Back off using the contention counter passed among the arguments of a CAS (if any)
+template<typename ...Args>
+void backoff_on_contention (const Args &... args) noexcept {
+	([] (const auto &arg) {
+	  if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, ContentionFailureCounter>) { arg.backoff(); }
+	}(args), ...);
+}
+
+/// \brief Two machine words which are loaded and CAS-ed as a single unit
+struct alignas(16) DoubleWord {
+  uint64_t lo{0};
+  uint64_t hi{0};
+  bool operator== (const DoubleWord &rhs) const = default;
+};
+
+/// \brief An atomic DoubleWord. Uses cmpxchg16b on x86-64 and std::atomic (usually libatomic) elsewhere.
+class AtomicDoubleWord {
+ public:
+#ifdef TELAMON_HAS_DWCAS
+  explicit AtomicDoubleWord (DoubleWord word = {}) : m_halves{word.lo, word.hi} {}
+#else
+  explicit AtomicDoubleWord (DoubleWord word = {}) : m_word{word} {}
+#endif
+
+  /// \brief Loads both halves consistently
+  /// \details With cmpxchg16b the halves are read separately and the upper one is read twice. Every successful update
+  /// 			changes the upper half (it contains the version), so the pair is consistent iff both reads of it match.
+  [[nodiscard]] auto load () const noexcept -> DoubleWord {
+#ifdef TELAMON_HAS_DWCAS
+	  while (true) {
+		  const auto hi = m_halves[1].load(std::memory_order_acquire);
+		  const auto lo = m_halves[0].load(std::memory_order_acquire);
+		  if (m_halves[1].load(std::memory_order_acquire) == hi) {
+			  return DoubleWord{lo, hi};
+		  }
+	  }
+#else
+	  return m_word.load();
+#endif
+  }
+
+  auto compare_exchange (const DoubleWord &expected, const DoubleWord &desired) noexcept -> bool {
+#ifdef TELAMON_HAS_DWCAS
+	  auto lo = expected.lo;
+	  auto hi = expected.hi;
+	  bool swapped;
+	  __asm__ __volatile__ ("lock cmpxchg16b %1"
+	                        : "=@ccz" (swapped), "+m" (m_halves), "+a" (lo), "+d" (hi)
+	                        : "b" (desired.lo), "c" (desired.hi)
+	                        : "memory");
+	  return swapped;
+#else
+	  auto expected_copy = expected;
+	  return m_word.compare_exchange_strong(expected_copy, desired);
+#endif
+  }
+
+ private:
+#ifdef TELAMON_HAS_DWCAS
+  static_assert(std::atomic<uint64_t>::is_always_lock_free && sizeof(std::atomic<uint64_t>) == sizeof(uint64_t));
+  /// The word is only accessed as two atomic halves from C++, and as a whole by the cmpxchg16b above. On x86-64 an aligned
+  /// 8-byte load is atomic and a locked cmpxchg16b writes both halves at once, thus the loads of the halves never observe a
+  /// partial update (mixing the two sizes is defined by the x86-64 memory model, not by the C++ one).
+  alignas(16) std::array<std::atomic<uint64_t>, 2> m_halves;
+#else
+  std::atomic<DoubleWord> m_word;
+#endif
+};
+
 /// \brief Base class for the \e Referenced class which contains the common data between different template classes
 template<typename ValType>
 struct ReferencedBase {
@@ -92,10 +186,17 @@ struct Referenced<ValType, void> : telamon_private::ReferencedBase<ValType> {
 	  : telamon_private::ReferencedBase<ValType>{rhs.value, rhs.version} {}
 };
 
+/// \brief A copy of a cell which can be used in place of a pointer to it
+template<typename Cell>
+struct CellSnapshot {
+  Cell cell;
+  auto operator-> () const noexcept -> const Cell * { return &cell; }
+};
+
 /// \brief An atomic primitive which support versioning. The type which is wrapper has additional meta data.
 /// \note T has to implement comparison operators
 /// \copydetails Versioning.hh
-template<typename ValType, typename Meta=void>
+template<typename ValType, typename Meta=void, typename Repr=ReferencedCells>
 class [[maybe_unused]] VersionedAtomic {
  public:
 
@@ -106,12 +207,19 @@ class [[maybe_unused]] VersionedAtomic {
   [[maybe_unused]] explicit VersionedAtomic (ValType value, Meta meta = {})
 	  : m_ptr{std::atomic(new Referenced<ValType, Meta>{std::move(value), std::move(meta)})} {}
 
+  /// \brief Copies the current cell. Sharing it would make it impossible to tell when it can be reclaimed.
   VersionedAtomic (const VersionedAtomic &rhs)
-	  : m_ptr{rhs.m_ptr.load()} {}
+	  : m_ptr{new Referenced<ValType, Meta>{*rhs.load()}} {}
+
+  ~VersionedAtomic () { hazard_pointers::retire(m_ptr.load()); }
 
  public:
   /// \brief Load the value stored inside
-  [[maybe_unused]] auto load () const noexcept -> Referenced<ValType, Meta> * { return m_ptr.load(); }
+  /// \note  The returned cell is protected for as long as the guard lives. The first ROTATING_SLOTS guards held by a thread
+  /// 		 take its rotating slots and any further ones take slower overflow hazards.
+  [[maybe_unused]] auto load () const noexcept -> hazard_pointers::HazardGuard<Referenced<ValType, Meta>> {
+	  return hazard_pointers::protect(m_ptr);
+  }
 
   /// \brief Store a value inside
   [[maybe_unused]] auto store (ValType new_value, std::optional<Meta> new_meta = {}) noexcept {
@@ -124,7 +232,7 @@ class [[maybe_unused]] VersionedAtomic {
 		  (new_meta.has_value() ? new_meta.value() : ptr->meta),
 		  actual_version + 1
 	  };
-	  m_ptr.store(new_ptr);
+	  hazard_pointers::retire(m_ptr.exchange(new_ptr));
   }
 
   /// \brief Apply a function to the value inside
@@ -132,11 +240,11 @@ class [[maybe_unused]] VersionedAtomic {
   /// \param  fun 	The function applied to the value inside
   template<typename Fun/*, typename Ret*/>
   [[maybe_unused]] auto transform (Fun fun) const {
-	  auto loaded = m_ptr.load();
+	  auto loaded = load();
 	  return fun(loaded->value, loaded->version, loaded->meta);
   }
 
-  [[nodiscard]] auto version () const noexcept -> VersionNum { return m_ptr.load()->version; }
+  [[nodiscard]] auto version () const noexcept -> VersionNum { return load()->version; }
 
   /// \brief Performs a CAS on the value stored inside
   /// \param expected 	The expected value
@@ -167,20 +275,26 @@ class [[maybe_unused]] VersionedAtomic {
 		  return std::make_optional(true);
 	  }
 
-	  // TODO: Hazptr
 	  auto new_ref = new Referenced<ValType, Meta>{std::move(desired), std::move(desired_meta), actual_version + 1};
 
-	  auto cas_result = std::make_optional(m_ptr.compare_exchange_strong(ptr, new_ref));
-	  if (!cas_result && failures.detect()) { return std::nullopt; } //< Contention
-	  if (cas_result && cas_result.value() == true) { m_modified_bit.store(true); }
-	  return cas_result;
+	  auto *expected_ptr = ptr.get();
+	  if (!m_ptr.compare_exchange_strong(expected_ptr, new_ref)) {
+		  delete new_ref; //< Never got shared with other threads
+		  return std::make_optional(false);
+	  }
+	  m_modified_bit.store(true);
+	  hazard_pointers::retire(expected_ptr);
+	  return std::make_optional(true);
   }
 
   template<typename ...Args>
   [[maybe_unused]] auto compare_exchange_strong (Args &&... args) -> bool {
 	  while (true) {
 		  auto res = compare_exchange_weak(std::forward<Args>(args)...);
-		  if (res == std::nullopt) continue;
+		  if (res == std::nullopt) {
+			  telamon_private::backoff_on_contention(args...);
+			  continue;
+		  }
 		  return res.value();
 	  }
   }
@@ -199,15 +313,21 @@ class [[maybe_unused]] VersionedAtomic {
 
 /// \brief An atomic primitive which support versioning. The type which is wrapper has no additional meta data.
 template<typename ValType>
-class VersionedAtomic<ValType, void> {
+class VersionedAtomic<ValType, void, ReferencedCells> {
  public:
   explicit VersionedAtomic (ValType &&value) : m_ptr{std::atomic(new Referenced<ValType>{std::forward<ValType>(value)})} {}
   VersionedAtomic (const VersionedAtomic &) = delete;
   VersionedAtomic (VersionedAtomic &&) noexcept = default;
 
+  ~VersionedAtomic () { hazard_pointers::retire(m_ptr.load()); }
+
  public:
   /// \brief Load the value stored inside
-  [[maybe_unused]] auto load () const noexcept -> Referenced<ValType> * { return m_ptr.load(); }
+  /// \note  The returned cell is protected for as long as the guard lives. The first ROTATING_SLOTS guards held by a thread
+  /// 		 take its rotating slots and any further ones take slower overflow hazards.
+  [[maybe_unused]] auto load () const noexcept -> hazard_pointers::HazardGuard<Referenced<ValType>> {
+	  return hazard_pointers::protect(m_ptr);
+  }
 
   /// \brief Store a value inside
   [[maybe_unused]] auto store (ValType new_value) noexcept {
@@ -216,7 +336,7 @@ class VersionedAtomic<ValType, void> {
 	  auto actual_version = ptr->version;
 	  if (actual == new_value) { return; }
 	  auto new_ptr = new Referenced<ValType>{std::move(new_value), actual_version + 1};
-	  m_ptr.store(new_ptr);
+	  hazard_pointers::retire(m_ptr.exchange(new_ptr));
   }
 
   /// \brief Apply a function to the value inside
@@ -224,7 +344,7 @@ class VersionedAtomic<ValType, void> {
   /// \param  fun 	The function applied to the value inside
   template<typename Fun/*, typename Ret*/>
   [[maybe_unused]] auto transform (Fun fun) /* -> Ret */ {
-	  auto loaded = m_ptr.load();
+	  auto loaded = load();
 	  return fun(loaded->value, loaded->version);
   }
 
@@ -253,20 +373,26 @@ class VersionedAtomic<ValType, void> {
 		  return std::make_optional(true);
 	  }
 
-	  // TODO: Hazptr
 	  auto new_ptr = new Referenced<ValType>{std::move(desired), actual_version + 1};
 
-	  auto cas_result = std::make_optional(m_ptr.compare_exchange_strong(ptr, new_ptr));
-	  if (!cas_result && failures.detect()) { return std::nullopt; } //< Contention
-	  if (cas_result) { m_modified_bit.store(true); }
-	  return cas_result;
+	  auto *expected_ptr = ptr.get();
+	  if (!m_ptr.compare_exchange_strong(expected_ptr, new_ptr)) {
+		  delete new_ptr; //< Never got shared with other threads
+		  return std::make_optional(false);
+	  }
+	  m_modified_bit.store(true);
+	  hazard_pointers::retire(expected_ptr);
+	  return std::make_optional(true);
   }
 
   template<typename ...Args>
   [[maybe_unused]] auto compare_exchange_strong (Args &&... args) -> bool {
 	  while (true) {
 		  auto res = compare_exchange_weak(std::forward<Args>(args)...);
-		  if (res == std::nullopt) continue;
+		  if (res == std::nullopt) {
+			  telamon_private::backoff_on_contention(args...);
+			  continue;
+		  }
 		  return res.value();
 	  }
   }
@@ -283,6 +409,253 @@ class VersionedAtomic<ValType, void> {
   std::atomic<bool> m_modified_bit{false};
 };
 
+/// \brief An atomic primitive which support versioning, kept inline in a double word instead of a heap cell
+/// \details The lower word holds the value and the upper one holds the meta (lowest 16 bits) and the version (the rest). Loads
+/// 		  return a CellSnapshot instead of a pointer, so neither loads nor CAS-es allocate or chase a pointer.
+template<typename ValType, typename Meta>
+class VersionedAtomic<ValType, Meta, InlineDoubleWord> {
+  static_assert(std::is_trivially_copyable_v<ValType> && sizeof(ValType) <= sizeof(uint64_t),
+                "InlineDoubleWord requires a trivially copyable value of at most 8 bytes.");
+  static_assert(std::is_trivially_copyable_v<Meta> && sizeof(Meta) <= sizeof(uint16_t),
+                "InlineDoubleWord requires a trivially copyable meta of at most 2 bytes.");
+
+  constexpr static inline int META_BITS = 16;
+
+ public:
+  template<typename ...Args>
+  explicit VersionedAtomic (Meta meta, Args &&... args)
+	  : m_word{encode(ValType{std::forward<Args>(args)...}, meta, 0)} {}
+
+  [[maybe_unused]] explicit VersionedAtomic (ValType value, Meta meta = {})
+	  : m_word{encode(value, meta, 0)} {}
+
+  VersionedAtomic (const VersionedAtomic &rhs)
+	  : m_word{rhs.m_word.load()} {}
+
+ public:
+  /// \brief Load a copy of the value stored inside
+  [[maybe_unused]] auto load () const noexcept -> CellSnapshot<Referenced<ValType, Meta>> {
+	  return decode(m_word.load());
+  }
+
+  /// \brief Store a value inside
+  [[maybe_unused]] auto store (ValType new_value, std::optional<Meta> new_meta = {}) noexcept {
+	  while (true) {
+		  const auto word = m_word.load();
+		  const auto current = decode(word);
+		  if (current->value == new_value) { return; }
+		  const auto meta = new_meta.has_value() ? new_meta.value() : current->meta;
+		  if (m_word.compare_exchange(word, encode(new_value, meta, current->version + 1))) { return; }
+	  }
+  }
+
+  /// \brief Apply a function to the value inside
+  /// \param  fun 	The function applied to the value inside
+  template<typename Fun>
+  [[maybe_unused]] auto transform (Fun fun) const {
+	  const auto loaded = load();
+	  return fun(loaded->value, loaded->version, loaded->meta);
+  }
+
+  [[nodiscard]] auto version () const noexcept -> VersionNum { return load()->version; }
+
+  /// \brief Performs a CAS on the value stored inside
+  /// \copydetails VersionedAtomic::compare_exchange_weak
+  [[maybe_unused]] auto compare_exchange_weak (const ValType &expected,
+                                               std::optional<versioning::VersionNum> expected_version_opt,
+                                               ValType desired,
+                                               Meta desired_meta,
+                                               ContentionFailureCounter &failures) -> std::optional<bool> {
+	  const auto word = m_word.load();
+	  const auto actual = decode(word);
+	  if (expected != actual->value) {
+		  return std::make_optional(false);
+	  }
+
+	  if (expected_version_opt && expected_version_opt.value() != actual->version) {
+		  if (failures.detect()) { return std::nullopt; }       //< Contention
+		  return std::make_optional(false);
+	  }
+
+	  if (actual->value == desired && actual->meta == desired_meta) {
+		  return std::make_optional(true);
+	  }
+
+	  if (!m_word.compare_exchange(word, encode(desired, desired_meta, actual->version + 1))) {
+		  return std::make_optional(false);
+	  }
+	  m_modified_bit.store(true);
+	  return std::make_optional(true);
+  }
+
+  template<typename ...Args>
+  [[maybe_unused]] auto compare_exchange_strong (Args &&... args) -> bool {
+	  while (true) {
+		  auto res = compare_exchange_weak(std::forward<Args>(args)...);
+		  if (res == std::nullopt) {
+			  telamon_private::backoff_on_contention(args...);
+			  continue;
+		  }
+		  return res.value();
+	  }
+  }
+
+  [[nodiscard]] auto has_modified_bit () const noexcept -> bool { return m_modified_bit.load(); }
+
+  void clear_modified_bit () noexcept {
+	  auto expected = false;
+	  auto _ = m_modified_bit.compare_exchange_strong(expected, true);
+  }
+
+ private:
+  static auto encode (const ValType &value, const Meta &meta, VersionNum version) noexcept -> telamon_private::DoubleWord {
+	  auto word = telamon_private::DoubleWord{};
+	  std::memcpy(&word.lo, &value, sizeof(ValType));
+	  uint64_t meta_bits = 0;
+	  std::memcpy(&meta_bits, &meta, sizeof(Meta));
+	  word.hi = (version << META_BITS) | meta_bits;
+	  return word;
+  }
+
+  static auto decode (const telamon_private::DoubleWord &word) noexcept -> CellSnapshot<Referenced<ValType, Meta>> {
+	  ValType value;
+	  std::memcpy(&value, &word.lo, sizeof(ValType));
+	  Meta meta;
+	  const uint64_t meta_bits = word.hi & ((uint64_t{1} << META_BITS) - 1);
+	  std::memcpy(static_cast<void *>(&meta), &meta_bits, sizeof(Meta));
+	  return CellSnapshot<Referenced<ValType, Meta>>{Referenced<ValType, Meta>{value, meta, word.hi >> META_BITS}};
+  }
+
+ private:
+  telamon_private::AtomicDoubleWord m_word;
+  std::atomic<bool> m_modified_bit{false};
+};
+
+/// \brief An atomic primitive which support versioning, packed together with a mark bit into a tagged pointer
+/// \copydetails PackedWord
+template<typename ValType, typename Meta>
+class VersionedAtomic<ValType, Meta, PackedWord> {
+  static_assert(std::is_pointer_v<ValType>, "PackedWord requires a pointer value.");
+  static_assert(std::is_trivially_copyable_v<Meta> && sizeof(Meta) == 1,
+                "PackedWord requires a single-byte meta whose only state is the lowest bit (e.g. a bool flag).");
+
+  constexpr static inline int VERSION_SHIFT = 48;
+  constexpr static inline uint64_t MARK_MASK = 1;
+  constexpr static inline uint64_t POINTER_MASK = ((uint64_t{1} << VERSION_SHIFT) - 1) & ~MARK_MASK;
+
+ public:
+  template<typename ...Args>
+  explicit VersionedAtomic (Meta meta, Args &&... args)
+	  : m_word{encode(ValType{std::forward<Args>(args)...}, meta, 0)} {}
+
+  [[maybe_unused]] explicit VersionedAtomic (ValType value, Meta meta = {})
+	  : m_word{encode(value, meta, 0)} {}
+
+  VersionedAtomic (const VersionedAtomic &rhs)
+	  : m_word{rhs.m_word.load()} {}
+
+ public:
+  /// \brief Load a copy of the value stored inside. The version is the truncated 16-bit one.
+  [[maybe_unused]] auto load () const noexcept -> CellSnapshot<Referenced<ValType, Meta>> {
+	  return decode(m_word.load());
+  }
+
+  /// \brief Store a value inside
+  [[maybe_unused]] auto store (ValType new_value, std::optional<Meta> new_meta = {}) noexcept {
+	  auto word = m_word.load();
+	  while (true) {
+		  const auto current = decode(word);
+		  if (current->value == new_value) { return; }
+		  const auto meta = new_meta.has_value() ? new_meta.value() : current->meta;
+		  if (m_word.compare_exchange_weak(word, encode(new_value, meta, current->version + 1))) { return; }
+	  }
+  }
+
+  /// \brief Apply a function to the value inside
+  /// \param  fun 	The function applied to the value inside
+  template<typename Fun>
+  [[maybe_unused]] auto transform (Fun fun) const {
+	  const auto loaded = load();
+	  return fun(loaded->value, loaded->version, loaded->meta);
+  }
+
+  [[nodiscard]] auto version () const noexcept -> VersionNum { return load()->version; }
+
+  /// \brief Performs a CAS on the value stored inside
+  /// \note  The expected version is compared modulo 2^16
+  /// \copydetails VersionedAtomic::compare_exchange_weak
+  [[maybe_unused]] auto compare_exchange_weak (const ValType &expected,
+                                               std::optional<versioning::VersionNum> expected_version_opt,
+                                               ValType desired,
+                                               Meta desired_meta,
+                                               ContentionFailureCounter &failures) -> std::optional<bool> {
+	  auto word = m_word.load();
+	  const auto actual = decode(word);
+	  if (expected != actual->value) {
+		  return std::make_optional(false);
+	  }
+
+	  if (expected_version_opt && truncate(expected_version_opt.value()) != actual->version) {
+		  if (failures.detect()) { return std::nullopt; }       //< Contention
+		  return std::make_optional(false);
+	  }
+
+	  if (actual->value == desired && actual->meta == desired_meta) {
+		  return std::make_optional(true);
+	  }
+
+	  if (!m_word.compare_exchange_strong(word, encode(desired, desired_meta, actual->version + 1))) {
+		  return std::make_optional(false);
+	  }
+	  m_modified_bit.store(true);
+	  return std::make_optional(true);
+  }
+
+  template<typename ...Args>
+  [[maybe_unused]] auto compare_exchange_strong (Args &&... args) -> bool {
+	  while (true) {
+		  auto res = compare_exchange_weak(std::forward<Args>(args)...);
+		  if (res == std::nullopt) {
+			  telamon_private::backoff_on_contention(args...);
+			  continue;
+		  }
+		  return res.value();
+	  }
+  }
+
+  [[nodiscard]] auto has_modified_bit () const noexcept -> bool { return m_modified_bit.load(); }
+
+  void clear_modified_bit () noexcept {
+	  auto expected = false;
+	  auto _ = m_modified_bit.compare_exchange_strong(expected, true);
+  }
+
+ private:
+  static auto truncate (VersionNum version) noexcept -> VersionNum { return version & 0xFFFF; }
+
+  static auto encode (ValType value, const Meta &meta, VersionNum version) noexcept -> uint64_t {
+	  // Checked here since the pointee is usually incomplete when the link is declared (e.g. Node::m_next)
+	  static_assert(alignof(std::remove_pointer_t<ValType>) >= 2, "PackedWord requires a pointer to an (at least) 2-aligned type.");
+	  uint8_t meta_bits = 0;
+	  std::memcpy(&meta_bits, &meta, sizeof(Meta));
+	  return (truncate(version) << VERSION_SHIFT)
+		  | (reinterpret_cast<uintptr_t>(value) & POINTER_MASK)
+		  | (meta_bits & MARK_MASK);
+  }
+
+  static auto decode (uint64_t word) noexcept -> CellSnapshot<Referenced<ValType, Meta>> {
+	  const auto value = reinterpret_cast<ValType>(static_cast<uintptr_t>(word & POINTER_MASK));
+	  const auto meta_bits = static_cast<uint8_t>(word & MARK_MASK);
+	  Meta meta;
+	  std::memcpy(static_cast<void *>(&meta), &meta_bits, sizeof(Meta));
+	  return CellSnapshot<Referenced<ValType, Meta>>{Referenced<ValType, Meta>{value, meta, word >> VERSION_SHIFT}};
+  }
+
+ private:
+  std::atomic<uint64_t> m_word;
+  std::atomic<bool> m_modified_bit{false};
+};
+
 }
 }
 
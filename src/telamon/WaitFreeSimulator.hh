@@ -1,18 +1,23 @@
 #ifndef TELAMON_WAIT_FREE_SIMULATOR_HH_
 #define TELAMON_WAIT_FREE_SIMULATOR_HH_
 
+#include <array>
 #include <atomic>
+#include <coroutine>
 #include <memory>
 #include <concepts>
 #include <variant>
 #include <vector>
 #include <thread>
 #include <algorithm>
-#include <mutex>
+#include <bit>
+#include <chrono>
+#include <cstdint>
 #include <numeric>
 #include <utility>
 #include <type_traits>
 #include <optional>
+#include <span>
 
 #include <nonstd/expected.hpp>
 
@@ -25,6 +30,10 @@
 
 #include "HelpQueue.hh"
 #include "OperationHelping.hh"
+#include "EpochReclamation.hh"
+#include "SegmentedArray.hh"
+#include "Statistics.hh"
+#include "Tracing.hh"
 
 /// \brief Used by std::visit for the helping operation in the simulator
 template<class... T>
@@ -36,7 +45,8 @@ namespace telamon_simulator {
 namespace telamon_private {
 
 /// \brief The main structure of the simulator. Contains the operations performed by the simulator
-template<NormalizedRepresentation LockFree, const int N = 16>
+/// \tparam Policy Configures the contention thresholds and the backoff between retries (see ContentionPolicy.hh)
+template<NormalizedRepresentation LockFree, const int N = 16, ContentionManagement Policy = DefaultContentionPolicy>
 class WaitFreeSimulator {
   using Id = int;
   using Input = typename LockFree::Input;
@@ -50,6 +60,20 @@ class WaitFreeSimulator {
   template<typename T, typename Err = std::monostate>
   using OptionalResultOrError = nonstd::expected<std::optional<T>, Err>;
 
+  /// Success, or the index of the CAS which failed (none on contention)
+  using CommitResult = nonstd::expected<std::monostate, std::optional<int>>;
+
+  using EpochGuard = epoch_reclamation::EpochGuard<N>;
+
+  using HelpQueueStorage = helpqueue::PreallocatedNodes<>;
+  /// The number of operations of a batch which are enqueued at once. Keeps one preallocated slot for the last description
+  /// of the owner, so that enqueueing a group of a batch does not allocate either.
+  constexpr static inline std::size_t SLOW_PATH_GROUP = HelpQueueStorage::RING_SIZE - 1;
+
+ public:
+  /// The number of ids the per-participant state can grow to. N is only the granularity of the growth.
+  constexpr static inline int MAX_PARTICIPANTS = static_cast<int>(SegmentedArray<std::atomic<SuspendedOperation *>, N>::CAPACITY);
+
  public:
   explicit WaitFreeSimulator (const LockFree &lf) : m_algorithm{lf}, m_helpqueue{} {}
 
@@ -59,57 +83,86 @@ class WaitFreeSimulator {
 
   /// \brief 	Runs the actual simulation
   /// \param 	input The given input
-  /// \details	First, the operation is executed as if it was lock-free (the fast-path). If it fails FAST_PATH_RETRY_THRESHOLD number of times or if
+  /// \details	First, the operation is executed as if it was lock-free (the fast-path). If it fails FAST_PATH_RETRIES number of times or if
   ///           the contention threshold is reached, the fast-path is abandoned and the operation is switched to the slow-path, which asks the other
-  /// 			executing threads for help.
+  /// 			executing threads for help. Consecutive fast-path attempts are separated by the backoff of the policy.
+  /// \param 	help_first Whether to check the help queue before running the operation. The handles set it only every
+  /// 			`help delay` operations (the slow-path always helps).
+  /// \param 	predictor If given, the fast-path is skipped while the predictor expects it to fail
   /// \return 	The output of the operation
-  auto run (const Id id, const Input &input, bool use_slow_path = false) -> Output {
-	  auto contention_counter = ContentionFailureCounter{};
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "Running the simulation with id = '" << id << "' and input = '" << input << "'";
-	  LOG_IF_F(INFO, use_slow_path, "Setting a preference to use the slow path");
-#endif
-	  try_help_others(id);
+  auto run (const Id id, const Input &input, bool use_slow_path = false, bool help_first = true, PathPredictor *predictor = nullptr) -> Output {
+	  const auto guard = EpochGuard{m_epochs, id};
+	  auto contention_counter = Policy::make_counter();
+	  if (help_first) { try_help_others(id); }
 
 	  if (!use_slow_path) {
-		  for (int i = 0; i < ContentionFailureCounter::FAST_PATH_RETRY_THRESHOLD; ++i) {
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Retry #" << i << "using the fast-path with input = " << input;
-#endif
-			  auto fp_result = fast_path(input, contention_counter);
-			  if (fp_result.has_value()) {
-#ifdef TEL_LOGGING
-				  LOG_F(INFO, "Fast-path succeeded. Returning output");
-#endif
-				  return fp_result.value();
-			  }
-			  if (contention_counter.detect()) {
-#ifdef TEL_LOGGING
-				  LOG_F(INFO, "Contention detected. Using slow-path.");
-#endif
-				  break;
-			  }
+		  if (auto fp_result = predicted_fast_path(id, input, contention_counter, predictor); fp_result.has_value()) {
+			  return fp_result.value();
 		  }
 	  }
 
 	  return slow_path(id, input);
   }
 
+  /// \brief 	Starts the simulation without waiting for the slow-path
+  /// \return 	The output if the fast-path succeeded. Otherwise, the box of the operation which was enqueued on the slow-path
+  /// 			and which has to be passed to `poll_slow_path`/`await_slow_path` by the same id.
+  /// \note 	`input` is referenced by the box, so it has to outlive the operation
+  auto run_async (const Id id, const Input &input, bool help_first = true, PathPredictor *predictor = nullptr) -> nonstd::expected<Output, OpBox *> {
+	  const auto guard = EpochGuard{m_epochs, id};
+	  if (help_first) { try_help_others(id); }
+
+	  auto contention_counter = Policy::make_counter();
+	  if (auto fp_result = predicted_fast_path(id, input, contention_counter, predictor); fp_result.has_value()) {
+		  return fp_result.value();
+	  }
+	  return nonstd::make_unexpected(enqueue_slow_path(id, input));
+  }
+
+  /// \brief 	Runs the simulation for a batch of inputs
+  /// \details	The helping and the entry into the critical section are done once per batch. The fast-paths are run back to back
+  /// 			and the operations which fail them are enqueued on the slow-path together (in groups of SLOW_PATH_GROUP), after
+  /// 			which the owner helps until all of them are completed.
+  /// \note 	The outputs are written at the positions of the corresponding inputs. `outputs` has to be at least as long as
+  /// 			`inputs`, since the inputs which do not have a corresponding output are not run.
+  /// \return 	The number of operations which were run
+  auto run_batch (const Id id, std::span<const Input> inputs, std::span<Output> outputs, bool help_first = true, PathPredictor *predictor = nullptr) -> std::size_t {
+	  const auto guard = EpochGuard{m_epochs, id};
+	  const auto count = std::min(inputs.size(), outputs.size());
+	  if (help_first) { try_help_others(id); }
+
+	  std::vector<std::pair<std::size_t, OpBox *>> slow_ops;
+	  for (std::size_t i = 0; i < count; ++i) {
+		  auto contention_counter = Policy::make_counter();
+		  if (auto fp_result = predicted_fast_path(id, inputs[i], contention_counter, predictor); fp_result.has_value()) {
+			  outputs[i] = fp_result.value();
+		  } else {
+			  slow_ops.emplace_back(i, nullptr);
+		  }
+	  }
+
+	  for (std::size_t first = 0; first < slow_ops.size(); first += SLOW_PATH_GROUP) {
+		  const auto group = std::span{slow_ops}.subspan(first, std::min(SLOW_PATH_GROUP, slow_ops.size() - first));
+		  for (auto &[i, op_box] : group) { op_box = enqueue_slow_path(id, inputs[i]); }
+		  for (auto &[i, op_box] : group) { outputs[i] = await_slow_path(id, op_box); }
+	  }
+	  return count;
+  }
+
   /// \brief 	Checks whether other threads need help with a certain operation and tries to help them
   auto try_help_others (const Id id) -> void {
+	  // The box and its records may be retired by other threads while this one is still helping
+	  const auto guard = EpochGuard{m_epochs, id};
 	  auto front = m_helpqueue.peek_front();
 	  if (front.has_value()) {
-#ifdef TEL_LOGGING
-		  LOG_F(INFO, "Operation requires help in the helpq. Tryting to help it.");
-#endif
-		  help(*front.value());
+		  help(id, *front.value());
 	  }
   }
 
  private:
   /// \brief	Helps an operation in the precas stage
   auto help_precas (OpBox &op_box, const OpRecord &op, const typename OpRecord::PreCas &state) -> OptionalResultOrError<OpRecord *> {
-	  auto failures = ContentionFailureCounter{};
+	  auto failures = Policy::make_counter();
 
 	  // Generate CAS-list
 	  auto desc = m_algorithm.generator(op.input(), failures);
@@ -117,15 +170,15 @@ class WaitFreeSimulator {
 		  return nonstd::make_unexpected(std::monostate{});
 	  }
 
-	  auto updated_state = OpState{typename OpRecord::ExecutingCas(desc.value())};
+	  auto updated_state = OpState{typename OpRecord::ExecutingCas(std::move(desc.value()))};
 	  return new OpRecord{op, updated_state};
   }
 
   /// \brief	Helps an operation in the postcas stage
   auto help_postcas (OpBox &op_box, const OpRecord &op, const typename OpRecord::PostCas &state) -> OptionalResultOrError<OpRecord *> {
-	  auto failures = ContentionFailureCounter{};
+	  auto failures = Policy::make_counter();
 
-	  auto result_opt = m_algorithm.wrap_up(state.executed, state.cas_list, failures);
+	  auto result_opt = m_algorithm.wrap_up(state.executed, *state.cas_list, failures);
 	  if (!result_opt.has_value()) {
 		  // Contention encountered. Try again.
 		  return nonstd::make_unexpected(std::monostate{});
@@ -143,18 +196,19 @@ class WaitFreeSimulator {
   }
 
   /// \brief	Helps an operation in the stage during cas execution
-  auto help_executingcas (OpBox &op_box, const OpRecord &op, typename OpRecord::ExecutingCas &state) -> OptionalResultOrError<OpRecord *, int> {
-	  auto failures = ContentionFailureCounter{};
+  /// \details	A commit which failed at a specific CAS moves on to PostCas as well, where wrap_up decides whether the operation
+  /// 			is restarted. Only a commit which encountered contention is tried again.
+  auto help_executingcas (const Id id, OpBox &op_box, const OpRecord &op, const typename OpRecord::ExecutingCas &state) -> OptionalResultOrError<OpRecord *> {
+	  auto failures = Policy::make_counter();
 
-	  auto result = commit(state.cas_list, failures);
+	  auto result = commit(*state.cas_list, failures);
 	  if (!result.has_value()) {
-		  if (auto err = result.error(); err.has_value()) {
-			  // Contention encounter. Try again.
-			  return std::optional<OpRecord *>{};
-		  } else {
-			  // Failed at a specific CAS
-			  return nonstd::make_unexpected(err.value());
+		  tracing::trace(tracing::TraceEventKind::CommitFailed, id, &op_box, result.error().value_or(-1));
+		  if (!result.error().has_value()) {
+			  // Contention encountered. Try again.
+			  return nonstd::make_unexpected(std::monostate{});
 		  }
+		  record(id, [&] (auto &stats) { stats.count_commit_failure(static_cast<std::size_t>(result.error().value())); });
 	  }
 
 	  auto updated_op = new OpRecord{op, typename OpRecord::PostCas(state.cas_list, result)};
@@ -163,9 +217,10 @@ class WaitFreeSimulator {
 
 /// \brief 	Helps a specific operation
 /// \note 	After exiting this function the operation encapsulation in `op_box` will be completed
+/// \param 	id		The id of the helping thread. Records replaced by it are retired on its behalf.
 /// \param 	op_box	The operation box containing a ptr to the operation which requires help
 /// \details 	Implemented using the state of the operation and keep track of any modifications which occur during its processing
-  auto help (OperationRecordBox<LockFree> &op_box) -> void {
+  auto help (const Id id, OperationRecordBox<LockFree> &op_box) -> void {
 	  using HelperVisitResult = std::pair<bool, OptionalResultOrError<OpRecord *>>;
 	  while (true) {
 		  auto op_ptr = op_box.ptr();
@@ -173,67 +228,56 @@ class WaitFreeSimulator {
 
 		  auto[continue_, updated_op] = std::visit(OverloadedVisitor{
 			  [&] (const typename OpRecord::PreCas &arg) -> HelperVisitResult {
-#ifdef TEL_LOGGING
-				LOG_F(INFO, "Performing help of an operation in the PreCas state.");
-#endif
+				record(id, [] (auto &stats) { stats.count_help(HelpedState::PreCas); });
+				tracing::trace(tracing::TraceEventKind::Help, id, &op_box, static_cast<int>(HelpedState::PreCas));
 				auto result = help_precas(op_box, op, arg);
 				bool continue_ = !result.has_value(); //< If there is contention, try again (continue the outer loop)
 				return std::make_pair(continue_, result);
 			  },
 			  [&] (const typename OpRecord::ExecutingCas &arg) -> HelperVisitResult {
-#ifdef TEL_LOGGING
-				LOG_F(INFO, "Performing help of an operation in the ExecutingCas state.");
-#endif
-				auto &mut_arg = *const_cast<typename OpRecord::ExecutingCas *>(&arg);
-				auto result_ = help_executingcas(op_box, op, mut_arg);
-				// continue_ is set iff the execution failed and _none_ of the CAS-es was successfully performed
-				bool continue_ = result_.has_value() && !result_.value().has_value();
-				// help_executingcas has a different return type and has to be "reformatted"
-
-				// If continue_ is set then the value of result wil never be read
-				if (continue_) { return std::make_pair(continue_, nullptr); }
-
-				// value().value() is fine because we would have already returned if there wasn't a value in the optional<>
-				if (result_.has_value()) { return std::make_pair(continue_, result_.value().value()); }
-
-				auto unit = nonstd::make_unexpected(std::monostate{});
-				return std::make_pair(continue_, unit);
+				record(id, [] (auto &stats) { stats.count_help(HelpedState::ExecutingCas); });
+				tracing::trace(tracing::TraceEventKind::Help, id, &op_box, static_cast<int>(HelpedState::ExecutingCas));
+				auto result = help_executingcas(id, op_box, op, arg);
+				bool continue_ = !result.has_value(); //< If there is contention, try again (continue the outer loop)
+				return std::make_pair(continue_, result);
 			  },
 			  [&] (const typename OpRecord::PostCas &arg) -> HelperVisitResult {
-#ifdef TEL_LOGGING
-				LOG_F(INFO, "Performing help of an operation in the PostCas state.");
-#endif
+				record(id, [] (auto &stats) { stats.count_help(HelpedState::PostCas); });
+				tracing::trace(tracing::TraceEventKind::Help, id, &op_box, static_cast<int>(HelpedState::PostCas));
 				auto result = help_postcas(op_box, op, arg);
 				bool continue_ = !result.has_value(); //< If there is contention, try again (continue the outer loop)
 				return std::make_pair(continue_, result);
 			  },
 			  [&] (const typename OpRecord::Completed &arg) -> HelperVisitResult {
-#ifdef TEL_LOGGING
-				LOG_F(INFO, "Performing help of an operation in the Completed state.");
-#endif
+				record(id, [] (auto &stats) { stats.count_help(HelpedState::Completed); });
+				tracing::trace(tracing::TraceEventKind::Help, id, &op_box, static_cast<int>(HelpedState::Completed));
 				auto _ = m_helpqueue.try_pop_front(&op_box);
-				auto updated_state = op_box.state();
-				return std::make_pair(false, std::make_optional(new OpRecord{op, updated_state}));
+				// Nothing left to be updated
+				return std::make_pair(false, std::optional<OpRecord *>{});
 			  }
 		  }, op.state());
 
 		  if (continue_) { continue; }
-		  if (!updated_op) { break; }
+		  if (!updated_op || !updated_op.value().has_value()) { break; }
 
 		  // Safety for calling value().value(): continue_ would be true and thus we wouldn't have reached this line
 		  OpRecord *updated_op_ptr = updated_op.value().value();
 		  if (!op_box.atomic_ptr().compare_exchange_strong(op_ptr, updated_op_ptr)) {
 			  // Unsuccessful, therefore we can safely deallocate the OpRecord we created (It never got shared with other threads).
-#ifdef TEL_LOGGING
-			  LOG_F(WARNING, "CAS during help of an operation failed.");
-#endif
+			  record(id, [] (auto &stats) { ++stats.failed_box_cas; });
+			  tracing::trace(tracing::TraceEventKind::BoxCasFailed, id, &op_box, static_cast<int>(updated_op_ptr->state().index()));
 			  delete updated_op_ptr;
+		  } else {
+			  tracing::trace(tracing::TraceEventKind::Transition, id, &op_box, static_cast<int>(updated_op_ptr->state().index()));
+			  // The replaced record may still be read by other helpers
+			  m_epochs.retire(id, op_ptr);
+			  if (std::holds_alternative<typename OpRecord::Completed>(updated_op_ptr->state())) {
+				  hand_over_waiter(op_box);
+				  op_box.notify_completed();
+			  }
 		  }
 
 		  if (std::holds_alternative<typename OpRecord::Completed>(op_box.state())) {
-#ifdef TEL_LOGGING
-			  LOG_F(INFO, "Operation which required help now finished. Returning from help.");
-#endif
 			  break;
 		  } //< Completed
 	  }
@@ -244,51 +288,91 @@ class WaitFreeSimulator {
 /// \return 	Either a success or an error:
 /// 				Success => The CAS was/were performed successfully
 /// 				Error => Either there was contention during the CAS execution, or the CAS failed (the params were incorrect)
-  auto commit (Commit &cas_list, ContentionFailureCounter &failures) -> nonstd::expected<std::monostate, std::optional<int>> {
-	  for (int i = 0; auto &cas : cas_list) {
-		  switch (auto state = cas.state()) {
-			  case CasStatus::Failure:
-#ifdef TEL_LOGGING
-				  LOG_F(WARNING, "During commit: CAS #%d failed.", i);
-#endif
-				  return nonstd::make_unexpected(i);
-				  break;
-			  case CasStatus::Success:
-#ifdef TEL_LOGGING
-				  LOG_F(INFO, "During commit: CAS was successfully executed. Clearing modified_bit and returning.");
-#endif
-				  cas.clear_bit();
-				  break;
-			  case CasStatus::Pending: {
-				  if (auto result = cas.execute(failures); !result) {
-#ifdef TEL_LOGGING
-					  LOG_F(INFO, "During commit: CAS #%d failed. Returning...", i);
-#endif
-					  return nonstd::make_unexpected(std::nullopt);
-				  }
-				  if (cas.has_modified_bit()) {
-					  (void) cas.swap_state(CasStatus::Pending, CasStatus::Success);
-					  cas.clear_bit();
-#ifdef TEL_LOGGING
-					  LOG_F(INFO, "During commit: CAS #%d succeeded. Getting to the next one.", i);
-#endif
-				  }
-				  if (cas.state() != CasStatus::Success) {
-					  cas.set_state(CasStatus::Failure);
-#ifdef TEL_LOGGING
-					  LOG_F(WARNING, "During commit: CAS #%d failed. Returning...", i);
-#endif
-					  return nonstd::make_unexpected(i);
-				  }
-				  break;
+/// \details 	Commits of a fixed size are unrolled at compile time and a single CAS settles its status in one step (see
+/// 			commit_single_cas). Other commits are iterated as ranges.
+  auto commit (Commit &cas_list, ContentionFailureCounter &failures) -> CommitResult {
+	  if constexpr (FixedSizeCommits<Commit>) {
+		  constexpr auto size = std::tuple_size_v<Commit>;
+		  if constexpr (size == 1) {
+			  return commit_single_cas(std::get<0>(cas_list), failures);
+		  } else {
+			  // Unrolled. Stops at the first CAS which does not succeed.
+			  auto result = CommitResult{std::monostate{}};
+			  [&]<std::size_t... I> (std::index_sequence<I...>) {
+				(void) ((result = commit_cas(std::get<I>(cas_list), static_cast<int>(I), failures)).has_value() && ...);
+			  }(std::make_index_sequence<size>{});
+			  return result;
+		  }
+	  } else {
+		  for (int i = 0; auto &cas : cas_list) {
+			  if (auto result = commit_cas(cas, i, failures); !result.has_value()) {
+				  return result;
 			  }
+			  ++i;
 		  }
-		  ++i;
+		  return std::monostate{};
 	  }
+  }
 
-#ifdef TEL_LOGGING
-	  LOG_F(INFO, "During commit: All CAS-es succeeded. Returning...");
-#endif
+/// \brief 	Make progress on the CAS number `index` of a commit
+/// \details 	The statuses are shared by every helper of the attempt. A CAS is marked as Success once `execute` reports it in
+/// 			effect and its modified bit is set, and as Failure once `execute` reports that it can no longer take effect.
+/// 			A CAS which is in effect but whose modified bit is not set yet (the helper which performed it may not have set
+/// 			it) is retried as contention.
+  template<typename Cas>
+  auto commit_cas (Cas &cas, const int index, ContentionFailureCounter &failures) -> CommitResult {
+	  switch (cas.state()) {
+		  case CasStatus::Failure:
+			  return nonstd::make_unexpected(index);
+		  case CasStatus::Success:
+			  cas.clear_bit();
+			  return std::monostate{};
+		  case CasStatus::Pending:
+			  break;
+	  }
+
+	  const auto executed = cas.execute(failures);
+	  if (!executed) {
+		  return nonstd::make_unexpected(std::nullopt);
+	  }
+	  if (executed.value() && cas.has_modified_bit()) {
+		  const auto swapped = cas.swap_state(CasStatus::Pending, CasStatus::Success);
+		  cas.clear_bit();
+		  if (swapped) { return std::monostate{}; }
+	  }
+	  if (!executed.value()) {
+		  (void) cas.swap_state(CasStatus::Pending, CasStatus::Failure);
+	  }
+	  switch (cas.state()) {
+		  case CasStatus::Success:
+			  return std::monostate{};
+		  case CasStatus::Failure:
+			  return nonstd::make_unexpected(index);
+		  case CasStatus::Pending:
+			  break;
+	  }
+	  return nonstd::make_unexpected(std::nullopt);
+  }
+
+/// \brief 	Make progress on a commit of a single CAS
+/// \details 	The status of the CAS is the outcome of the whole commit. The helpers settle it with a single status CAS from
+/// 			Pending to either Success or Failure, which is loaded again only if another helper settled it first. The
+/// 			modified bit is not cleared, since no later CAS of the commit relies on it and commit_cas trusts it only
+/// 			together with `execute` reporting the CAS in effect.
+  template<typename Cas>
+  auto commit_single_cas (Cas &cas, ContentionFailureCounter &failures) -> CommitResult {
+	  auto status = cas.state();
+	  if (status == CasStatus::Pending) {
+		  const auto executed = cas.execute(failures);
+		  if (!executed || (executed.value() && !cas.has_modified_bit())) {
+			  return nonstd::make_unexpected(std::nullopt);
+		  }
+		  const auto outcome = executed.value() ? CasStatus::Success : CasStatus::Failure;
+		  status = cas.swap_state(CasStatus::Pending, outcome) ? outcome : cas.state();
+	  }
+	  if (status != CasStatus::Success) {
+		  return nonstd::make_unexpected(0);
+	  }
 	  return std::monostate{};
   }
 
@@ -296,51 +380,190 @@ class WaitFreeSimulator {
 /// \details 	The slow-path begins as the thread-owner of the operation enqueues a succinct description of the operation it has failed to complete
 /// 			in the fast path (an OperationRecordBox).
   auto slow_path (const Id id, const Input &input) -> Output {
-	  // Enqueue description of the operation
+	  return await_slow_path(id, enqueue_slow_path(id, input));
+  }
+
+/// \brief 	Enqueue a description of the operation in the help queue
+  auto enqueue_slow_path (const Id id, const Input &input) -> OpBox * {
+	  // With several operations in flight the slots of the owner may all be taken. Helping completes the oldest of them.
+	  while (!m_helpqueue.has_free_slot(id)) { try_help_others(id); }
+	  record(id, [] (auto &stats) { ++stats.slow_path_entries; });
 	  auto *op_box = new OperationRecordBox<LockFree>{id, typename OpRecord::PreCas{}, input};
 	  m_helpqueue.push_back(id, op_box);
-#ifdef TEL_LOGGING
-	  LOG_S(INFO) << "During slowpath: Enqueueing a new operation record box in Precas state with input = " << input << " and id = " << id;
-#endif
+	  tracing::trace(tracing::TraceEventKind::SlowPathEnqueued, id, op_box);
+	  return op_box;
+  }
+
+ public:
+/// \brief 	Help until the enqueued operation is complete and return its output
+/// \details 	Between the rounds of helping the owner waits according to Policy::WAIT. It leaves its critical section while it
+/// 			waits, so that a parked owner does not hold back reclamation.
+  auto await_slow_path (const Id id, OpBox *op_box) -> Output {
+	  for (int round = 0; true; ++round) {
+		  {
+			  const auto guard = EpochGuard{m_epochs, id};
+			  if (auto output = poll_slow_path(id, op_box); output.has_value()) {
+				  return output.value();
+			  }
+			  try_help_others(id);
+		  }
+		  wait_for_helpers(*op_box, round);
+	  }
+  }
 
-	  // Help until operation is complete
+/// \brief 	Check whether the enqueued operation is complete without helping
+/// \return 	The output if the operation is complete. The box is retired in that case and must not be used anymore.
+  auto poll_slow_path (const Id id, OpBox *op_box) -> std::optional<Output> {
 	  using StateCompleted = typename OperationRecord<LockFree>::Completed;
-	  while (true) {
-		  auto updated_state = op_box->state();
-#ifdef TEL_LOGGING
-		  LOG_F(INFO, "During slow path: Checking the state the enqueued operation");
-#endif
-		  if (std::holds_alternative<StateCompleted>(updated_state)) {
-			  auto sp_result = std::get<StateCompleted>(updated_state);
-#ifdef TEL_LOGGING
-			  LOG_S(INFO) << "Operation succeeded with output = " << sp_result.output;
-#endif
-			  return sp_result.output;
+	  const auto guard = EpochGuard{m_epochs, id};
+	  const auto &updated_state = op_box->state();
+	  if (!std::holds_alternative<StateCompleted>(updated_state)) {
+		  return std::nullopt;
+	  }
+	  // The record is only retired below, and reclaimed after the guard is released
+	  const auto &sp_result = std::get<StateCompleted>(updated_state);
+	  tracing::trace(tracing::TraceEventKind::SlowPathCompleted, id, op_box);
+	  // A completed box is at the front of the help queue unless a helper already dequeued it
+	  (void) m_helpqueue.try_pop_front(op_box);
+	  m_epochs.retire(id, op_box, [] (void *ptr) {
+		auto *box = static_cast<OperationRecordBox<LockFree> *>(ptr);
+		delete box->ptr();
+		delete box;
+	  });
+	  return sp_result.output;
+  }
+
+/// \brief 	Register a coroutine which waits for the enqueued operation. Once the operation completes, the coroutine is handed
+/// 			over to the list of its owner (see `take_resumable`).
+/// \return 	False if the operation has already completed, in which case the coroutine should continue right away
+  auto suspend (OpBox *op_box, SuspendedOperation *waiter) -> bool {
+	  return op_box->attach_waiter(waiter);
+  }
+
+/// \brief 	Take the coroutines of `id` whose operations have been completed
+/// \return 	A list linked through SuspendedOperation::next, the most recently completed first
+  auto take_resumable (const Id id) -> SuspendedOperation * {
+	  return m_resumable.ensure(id).exchange(nullptr);
+  }
+
+/// \brief 	The statistics counted on behalf of `id`. All zeros unless TEL_STATISTICS is defined.
+  auto statistics (const Id id) const -> Statistics {
+	  return m_statistics.contains(static_cast<std::size_t>(id)) ? m_statistics[id].snapshot() : Statistics{};
+  }
+
+/// \brief 	The sum of the statistics of every id
+  auto statistics () const -> Statistics {
+	  auto total = Statistics{};
+	  m_statistics.for_each([&] (std::size_t, const StatisticsCounters &counters) { total += counters.snapshot(); });
+	  return total;
+  }
+
+ private:
+/// \brief 	Update the counters of `id` by `fun`. Compiled out unless TEL_STATISTICS is defined.
+  template<typename Fun>
+  auto record (const Id id, Fun &&fun) -> void {
+	  if constexpr (STATISTICS_ENABLED) {
+		  fun(m_statistics.ensure(static_cast<std::size_t>(id)));
+	  } else {
+		  (void) id;
+		  (void) fun;
+	  }
+  }
+
+/// \brief 	Give way to the helpers after round number `round` of helping did not complete the operation of the owner
+  auto wait_for_helpers (OpBox &op_box, const int round) -> void {
+	  using Step = SlowPathWait::Step;
+	  switch (Policy::WAIT.step(round)) {
+		  case Step::Spin:
+			  return;
+		  case Step::Yield:
+			  std::this_thread::yield();
+			  return;
+		  case Step::Park:
+			  op_box.park_owner(std::chrono::microseconds{Policy::WAIT.park_timeout});
+			  return;
+	  }
+  }
+
+/// \brief 	Push the coroutine waiting for a just completed operation (if any) to the list of the owner
+/// \note 	The coroutine is not resumed here since it would then run on the helping thread
+  auto hand_over_waiter (OpBox &op_box) -> void {
+	  auto *waiter = op_box.detach_waiter();
+	  if (!waiter) { return; }
+	  auto &resumable = m_resumable.ensure(op_box.ptr()->owner());
+	  auto *head = resumable.load();
+	  do {
+		  waiter->next = head;
+	  } while (!resumable.compare_exchange_weak(head, waiter));
+  }
+
+/// \brief 	Try the fast-path unless `predictor` expects it to fail, and update the predictor with the outcome
+  auto predicted_fast_path (const Id id, const Input &input, ContentionFailureCounter &contention_counter, PathPredictor *predictor)
+  -> std::optional<Output> {
+	  if (!predictor) { return retry_fast_path(id, input, contention_counter); }
+	  if (predictor->skip_fast_path()) {
+		  record(id, [] (auto &stats) { ++stats.fast_path_skips; });
+		  tracing::trace(tracing::TraceEventKind::FastPathSkipped, id, nullptr, predictor->estimate);
+		  predictor->record_skip();
+		  return std::nullopt;
+	  }
+	  auto fp_result = retry_fast_path(id, input, contention_counter);
+	  predictor->record(!fp_result.has_value());
+	  return fp_result;
+  }
+
+/// \brief 	Try the fast-path up to FAST_PATH_RETRIES times, backing off in between
+/// \return 	The output, or none if the operation has to be run on the slow-path
+  auto retry_fast_path (const Id id, const Input &input, ContentionFailureCounter &contention_counter) -> std::optional<Output> {
+	  auto fp_result = std::optional<Output>{};
+	  int attempts = 0;
+	  while (attempts < Policy::FAST_PATH_RETRIES) {
+		  ++attempts;
+		  tracing::trace(tracing::TraceEventKind::FastPathAttempt, id, nullptr, attempts);
+		  fp_result = fast_path(input, contention_counter);
+		  if (fp_result.has_value()) {
+			  tracing::trace(tracing::TraceEventKind::FastPathSucceeded, id, nullptr, attempts);
+			  break;
 		  }
-#ifdef TEL_LOGGING
-		  LOG_F(INFO, "During slow path: Operation still not finished. Trying to help again.");
-#endif
-		  try_help_others(id);
+		  if (contention_counter.detect()) {
+			  break;
+		  }
+		  contention_counter.backoff();
+	  }
+	  if (!fp_result.has_value()) {
+		  tracing::trace(tracing::TraceEventKind::FastPathAbandoned, id, nullptr, contention_counter.get());
 	  }
+	  record(id, [&] (auto &stats) {
+		stats.fast_path_attempts += static_cast<uint64_t>(attempts);
+		stats.fast_path_successes += fp_result.has_value() ? 1 : 0;
+		stats.contention_detections += static_cast<uint64_t>(contention_counter.get());
+	  });
+	  return fp_result;
   }
 
 /// \brief The fast-path. Directly invokes the fast_path of the algorithm being executed
   auto fast_path (const Input &input, ContentionFailureCounter &contention_counter) -> std::optional<Output> {
-#ifdef TEL_LOGGING
-	  LOG_F(INFO, "Invoking the fast path of the algorithm");
-#endif
 	  return m_algorithm.fast_path(input, contention_counter);
   }
 
  private:
   LockFree m_algorithm;
-  helpqueue::HelpQueue<OperationRecordBox<LockFree> *, N> m_helpqueue;
+  /// Enqueueing on the slow path does not allocate
+  helpqueue::HelpQueue<OperationRecordBox<LockFree> *, N, HelpQueueStorage> m_helpqueue;
+  epoch_reclamation::EpochDomain<N> m_epochs;
+  /// Coroutines whose operations are completed, per owner
+  SegmentedArray<std::atomic<SuspendedOperation *>, N> m_resumable;
+  /// Written only on behalf of the id which owns the counters. Stays empty unless TEL_STATISTICS is defined.
+  SegmentedArray<StatisticsCounters, N> m_statistics;
 };
 
 }
 
 /// \brief A handle class which is used to obtain access to the wait-free simulator
-template<NormalizedRepresentation LockFree, const int N = 16>
+/// \details Each handle checks whether other threads need help only every `help delay` submitted operations, as in the
+/// 		 original paper. An operation on the slow-path still gets help within N * delay operations of every other handle,
+/// 		 so the wait-free bound is kept while most fast-path operations do not touch the head of the help queue.
+template<NormalizedRepresentation LockFree, const int N = 16, ContentionManagement Policy = DefaultContentionPolicy>
 class WaitFreeSimulatorHandle {
  public:
   using Id = int;
@@ -355,39 +578,155 @@ class WaitFreeSimulatorHandle {
   template<typename T, typename Err = std::monostate>
   using OptionalResultOrError = nonstd::expected<std::optional<T>, Err>;
 
-  using Simulator = telamon_private::WaitFreeSimulator<LockFree, N>;
+  using Simulator = telamon_private::WaitFreeSimulator<LockFree, N, Policy>;
+
+  /// The default number of operations a handle submits between two checks of the help queue
+  constexpr static inline int DEFAULT_HELP_DELAY = 8;
 
  public:
 /// \brief A class which represents the meta data of the handle class. Used only when forking a handle from another and then retiring a handle.
+  /// \details The ids are allocated from a bitmap without locking. A claim sets the lowest clear bit it can win, so that the
+  /// 		  ids stay dense, and gives up on a bit once it has lost it. Thus a claim takes at most one atomic operation per
+  /// 		  id, no matter what the other threads are doing.
   struct MetaData {
-	std::vector<Id> m_free;
-	std::mutex m_free_lock;
+	constexpr static inline int WORD_BITS = 64;
+
+	explicit MetaData (const Id max_participants) {
+		for (std::size_t i = 0; i < m_claimed.size(); ++i) {
+			// Ids beyond the maximum are claimed forever
+			const auto first = static_cast<Id>(i) * WORD_BITS;
+			const auto available = std::clamp(max_participants - first, 0, WORD_BITS);
+			m_claimed.at(i).store(available == WORD_BITS ? 0 : ~uint64_t{0} << available, std::memory_order_relaxed);
+		}
+		m_claimed.front().fetch_or(1);    //< Owned by the original handle
+	}
+
+	/// \brief Claim the lowest free id
+	/// \return None if every id was claimed when the claim tried it
+	auto claim () -> std::optional<Id> {
+		for (std::size_t i = 0; i < m_claimed.size(); ++i) {
+			auto &word = m_claimed.at(i);
+			auto free_bits = ~word.load(std::memory_order_relaxed);
+			uint64_t tried = 0;
+			while ((free_bits & ~tried) != 0) {
+				const auto bit = std::countr_zero(free_bits & ~tried);
+				const auto mask = uint64_t{1} << bit;
+				const auto previous = word.fetch_or(mask, std::memory_order_acquire);
+				if ((previous & mask) == 0) {
+					return static_cast<Id>(i) * WORD_BITS + bit;
+				}
+				tried |= mask;
+				free_bits = ~previous;
+			}
+		}
+		return std::nullopt;
+	}
+
+	/// \brief Give back an id obtained with `claim`
+	void release (const Id id) {
+		const auto mask = uint64_t{1} << (id % WORD_BITS);
+		m_claimed.at(id / WORD_BITS).fetch_and(~mask, std::memory_order_release);
+	}
+
+	std::array<std::atomic<uint64_t>, (Simulator::MAX_PARTICIPANTS + WORD_BITS - 1) / WORD_BITS> m_claimed{};
+  };
+
+ public:
+  class Awaitable;
+
+  /// \brief The pending result of an operation submitted with `submit_async`
+  /// \details If the fast-path failed, the operation stays in the help queue and is driven to completion by the helpers. The
+  /// 		   token owns a copy of the input, since the enqueued operation refers to it.
+  /// \note 	A token must be used by the thread which owns the handle that created it, while the handle exists and before
+  /// 		it is retired. A pending token which is destroyed waits for the operation to complete.
+  class CompletionToken {
+   public:
+	CompletionToken (CompletionToken &&rhs) noexcept
+		: m_simulator{rhs.m_simulator},
+		  m_id{rhs.m_id},
+		  m_input{std::move(rhs.m_input)},
+		  m_box{std::exchange(rhs.m_box, nullptr)},
+		  m_output{std::move(rhs.m_output)} {}
+
+	CompletionToken (const CompletionToken &) = delete;
+	auto operator= (const CompletionToken &) -> CompletionToken & = delete;
+
+	~CompletionToken () {
+		if (m_box) { (void) get(); }
+	}
+
+   public:
+	/// \brief Check whether the operation is complete. Does not help other operations.
+	[[nodiscard]] auto ready () -> bool {
+		if (m_box) {
+			if (auto output = m_simulator->poll_slow_path(m_id, m_box); output.has_value()) {
+				complete(std::move(output.value()));
+			}
+		}
+		return m_output.has_value();
+	}
+
+	/// \brief Help until the operation is complete and return its output
+	auto get () -> Output {
+		if (m_box) { complete(m_simulator->await_slow_path(m_id, m_box)); }
+		return m_output.value();
+	}
+
+   private:
+	friend class WaitFreeSimulatorHandle;
+	friend class Awaitable;
+
+	CompletionToken (Simulator *t_simulator, Id t_id, const Input &t_input)
+		: m_simulator{t_simulator}, m_id{t_id}, m_input{std::make_unique<Input>(t_input)} {}
+
+	void complete (Output output) {
+		m_output.emplace(std::move(output));
+		m_box = nullptr;
+		m_input.reset();
+	}
+
+   private:
+	/// Kept alive by the handle which created the token
+	Simulator *m_simulator;
+	Id m_id;
+	/// Kept on the heap so that its address does not change when the token is moved
+	std::unique_ptr<Input> m_input;
+	OpBox *m_box{nullptr};
+	std::optional<Output> m_output{};
   };
 
  public: //< Construction API
-  explicit WaitFreeSimulatorHandle (LockFree algorithm)
-	  : m_id{0}, m_simulator{std::make_shared<Simulator>(algorithm)}, m_meta{std::make_shared<MetaData>()} {
-	  // Safe to access m_meta without atomic load because it has never been shared
-	  m_meta->m_free.resize(N - 1);
-	  std::iota(m_meta->m_free.begin(), m_meta->m_free.end(), 1);
+  /// \param max_participants The number of handles which may exist at once. Defaults to N, but may be larger (up to
+  /// 		 Simulator::MAX_PARTICIPANTS), in which case the state of the simulator grows by N ids whenever it is needed.
+  explicit WaitFreeSimulatorHandle (LockFree algorithm, int help_delay = DEFAULT_HELP_DELAY, int max_participants = N)
+	  : m_id{0},
+	    m_simulator{std::make_shared<Simulator>(algorithm)},
+	    m_sim{m_simulator.get()},
+	    m_meta{std::make_shared<MetaData>(std::clamp(max_participants, 1, Simulator::MAX_PARTICIPANTS))} {
+	  set_help_delay(help_delay);
 	  static_assert(N > 0, "N has to be a positive integer.");
   }
 
-  auto fork () -> std::optional<WaitFreeSimulatorHandle<LockFree, N>> {
+  auto fork () -> std::optional<WaitFreeSimulatorHandle> {
 	  auto meta = std::atomic_load(&m_meta);
-	  const auto lock = std::lock_guard<std::mutex>{meta->m_free_lock};
-	  if (meta->m_free.empty()) {
+	  const auto claimed = meta->claim();
+	  if (!claimed.has_value()) {
 #ifdef TEL_LOGGING
 		  LOG_F(WARNING, "New simulator handle CANNOT be created");
 #endif
 		  return {};
 	  }
-	  auto next_id = meta->m_free.back();
-	  meta->m_free.pop_back();
+	  const auto next_id = claimed.value();
 #ifdef TEL_LOGGING
 	  LOG_F(INFO, "New simulator handle created with id = %d", next_id);
 #endif
-	  return WaitFreeSimulatorHandle{next_id, m_simulator, meta};
+	  auto handle = WaitFreeSimulatorHandle{next_id, m_simulator, meta, m_help_delay};
+	  if (m_predictor.has_value()) {
+		  // The configuration is inherited, the estimate starts over
+		  handle.m_predictor = m_predictor;
+		  handle.m_predictor->estimate = 0;
+	  }
+	  return handle;
   }
 
   template<typename Fun, typename RetVal>
@@ -400,40 +739,155 @@ class WaitFreeSimulatorHandle {
 	  return std::nullopt;
   }
 
+  /// \brief Gives the id back and reclaims the cells which were retired by the calling thread
   auto retire () -> void {
+	  hazard_pointers::HazardPointerDomain::global().reclaim();
 	  auto meta = std::atomic_load(&m_meta);
-	  const auto lock = std::lock_guard{meta->m_free_lock};
-	  meta->m_free.push_back(m_id);
+	  meta->release(m_id);
 #ifdef TEL_LOGGING
 	  LOG_F(INFO, "Simulator handle with id = %d retired", m_id);
 #endif
   }
 
   auto submit (const Input &input, bool use_slow_path = false) -> Output {
-	  auto sim = std::atomic_load(&m_simulator);
+	  auto *sim = m_sim;
 #ifdef TEL_LOGGING
 	  LOG_S(INFO) << "Simulator was submitted a new operation with input = " << input;
 	  LOG_IF_F(INFO, use_slow_path, "Setting a preference to use the slow path");
 #endif
-	  return sim->run(m_id, input, use_slow_path);
+	  return sim->run(m_id, input, use_slow_path, should_help(), predictor());
+  }
+
+  /// \brief Submit an operation without waiting for the slow-path
+  /// \details The fast-path is tried as in `submit`. If it fails, the operation is enqueued in the help queue and the token
+  /// 		   is returned immediately, thus several slow-path operations of a handle may be in flight at once.
+  auto submit_async (const Input &input) -> CompletionToken {
+	  auto *sim = m_sim;
+#ifdef TEL_LOGGING
+	  LOG_S(INFO) << "Simulator was submitted a new asynchronous operation with input = " << input;
+#endif
+	  auto token = CompletionToken{sim, m_id, input};
+	  auto started = sim->run_async(m_id, *token.m_input, should_help(), predictor());
+	  if (started.has_value()) {
+		  token.complete(std::move(started.value()));
+	  } else {
+		  token.m_box = started.error();
+	  }
+	  return token;
+  }
+
+  /// \brief An operation which can be awaited from a coroutine. See `submit_co`.
+  class Awaitable {
+   public:
+	explicit Awaitable (CompletionToken t_token) : m_token{std::move(t_token)} {}
+
+	auto await_ready () -> bool { return m_token.ready(); }
+
+	auto await_suspend (std::coroutine_handle<> coroutine) -> bool {
+		m_suspended.coroutine = coroutine;
+		return m_token.m_simulator->suspend(m_token.m_box, &m_suspended);
+	}
+
+	auto await_resume () -> Output { return m_token.get(); }
+
+   private:
+	CompletionToken m_token;
+	SuspendedOperation m_suspended{};
+  };
+
+  /// \brief Submit an operation from a coroutine: `co_await handle.submit_co(input)`
+  /// \details Completes without suspending if the fast-path succeeds. Otherwise the coroutine is suspended until a helper
+  /// 		   completes the operation and is then resumed by `resume_completed` on the thread which owns the handle.
+  auto submit_co (const Input &input) -> Awaitable {
+	  return Awaitable{submit_async(input)};
+  }
+
+  /// \brief Resume the coroutines of this handle whose operations have been completed. Meant to be polled by the event loop
+  /// 		 of the thread which owns the handle (together with `help`).
+  /// \return The number of resumed coroutines
+  auto resume_completed () -> int {
+	  auto *sim = m_sim;
+	  // Reverse the list in order to resume in the order of completion
+	  SuspendedOperation *ordered = nullptr;
+	  for (auto *it = sim->take_resumable(m_id); it;) {
+		  auto *next = it->next;
+		  it->next = ordered;
+		  ordered = it;
+		  it = next;
+	  }
+	  int resumed = 0;
+	  while (ordered) {
+		  auto *next = ordered->next;   //< The awaitable owning `ordered` may be destroyed by resuming it
+		  ordered->coroutine.resume();
+		  ordered = next;
+		  ++resumed;
+	  }
+	  return resumed;
+  }
+
+  /// \brief Submit a batch of operations. The output of `inputs[i]` is written to `outputs[i]`.
+  /// \details The simulator is looked up and the help queue is checked once per batch rather than once per operation.
+  /// \return The number of operations which were run, i.e. the length of the shorter span
+  auto submit_batch (std::span<const Input> inputs, std::span<Output> outputs) -> std::size_t {
+	  auto *sim = m_sim;
+#ifdef TEL_LOGGING
+	  LOG_F(INFO, "Simulator was submitted a batch of %zu operations", inputs.size());
+#endif
+	  const auto help_first = should_help(static_cast<int>(std::min(inputs.size(), outputs.size())));
+	  return sim->run_batch(m_id, inputs, outputs, help_first, predictor());
   }
 
   auto help () -> void {
-	  auto sim = std::atomic_load(&m_simulator);
+	  auto *sim = m_sim;
 #ifdef TEL_LOGGING
 	  LOG_F(INFO, "Simulator is trying to help other threads");
 #endif
 	  sim->try_help_others(m_id);
   }
 
+  /// \brief Check the help queue once every `delay` submitted operations. A delay of 1 checks before every operation.
+  auto set_help_delay (int delay) -> void { m_help_delay = std::max(delay, 1); }
+
+  [[nodiscard]] auto help_delay () const noexcept -> int { return m_help_delay; }
+
+  /// \brief Skip the fast-path while the recent operations of this handle have failed it (see PathPredictor). Meant for
+  /// 		 bursts of contention on the same keys, during which the fast-path only wastes work. Disabled by default and by
+  /// 		 passing none. Handles forked afterwards inherit the setting.
+  auto set_path_predictor (std::optional<PathPredictor> predictor) -> void { m_predictor = predictor; }
+
+  [[nodiscard]] auto path_predictor () const noexcept -> const std::optional<PathPredictor> & { return m_predictor; }
+
+  /// \brief The statistics of the operations submitted through this handle and of the helping it did. Counted per id, thus
+  /// 		 they include the earlier handles which had the same id. All zeros unless TEL_STATISTICS is defined.
+  [[nodiscard]] auto statistics () const -> Statistics { return m_sim->statistics(m_id); }
+
+  /// \brief The statistics of all of the handles of the simulator added up
+  [[nodiscard]] auto snapshot () const -> Statistics { return m_sim->statistics(); }
+
  private:
-  WaitFreeSimulatorHandle (Id id, std::shared_ptr<Simulator> t_simulator, std::shared_ptr<MetaData> t_meta)
-	  : m_simulator{t_simulator}, m_id{id}, m_meta{t_meta} {}
+  WaitFreeSimulatorHandle (Id id, std::shared_ptr<Simulator> t_simulator, std::shared_ptr<MetaData> t_meta, int t_help_delay)
+	  : m_simulator{std::move(t_simulator)}, m_sim{m_simulator.get()}, m_meta{std::move(t_meta)}, m_id{id}, m_help_delay{t_help_delay} {}
+
+  auto predictor () noexcept -> PathPredictor * { return m_predictor.has_value() ? &m_predictor.value() : nullptr; }
+
+  /// \brief Counts the submitted operations. Only touches memory owned by the handle.
+  auto should_help (int num_ops = 1) noexcept -> bool {
+	  m_ops_since_help += num_ops;
+	  if (m_ops_since_help < m_help_delay) { return false; }
+	  m_ops_since_help = 0;
+	  return true;
+  }
 
  private:
+  /// Keeps the simulator alive for as long as the handle exists. Never reassigned, thus the operations of the handle use the
+  /// cached `m_sim` and do not touch the shared reference count.
   std::shared_ptr<Simulator> m_simulator{};
+  Simulator *m_sim{nullptr};
   std::shared_ptr<MetaData> m_meta{};
   Id m_id;
+  int m_help_delay{DEFAULT_HELP_DELAY};
+  int m_ops_since_help{0};
+  std::optional<PathPredictor> m_predictor{};
 
  public:
   [[maybe_unused]] static inline constexpr bool Use_slow_path = true;
@@ -0,0 +1,120 @@
+#ifndef TELAMON_TESTS_FAKE_ALGORITHM_HH_
+#define TELAMON_TESTS_FAKE_ALGORITHM_HH_
+
+//! \file 		FakeAlgorithm.hh
+//! \brief 		A configurable normalized algorithm which does not touch any structure, shared by the unit tests of the simulator
+//! \details 	Its CAS-es take effect when executed and the outcomes of the fast-path and of the commit are given by a Config.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+
+#include <nonstd/expected.hpp>
+
+#include <telamon/NormalizedRepresentation.hh>
+
+namespace telamon_testsuite_fakes {
+
+using telamon_simulator::CasStatus;
+using telamon_simulator::ContentionFailureCounter;
+
+/// \brief A CAS which takes effect whenever it is executed, unless it loses
+struct FakeCas {
+  FakeCas (int t_delay = 0, bool t_loses = false) : delay{t_delay}, loses{t_loses} {}
+
+  FakeCas (const FakeCas &rhs)
+	  : delay{rhs.delay},
+	    loses{rhs.loses},
+	    executions{rhs.executions.load()},
+	    status{rhs.status.load()} {}
+
+  auto has_modified_bit () const noexcept -> bool { return executions.load() > delay; }
+  auto clear_bit () const noexcept {}
+  auto state () const noexcept -> CasStatus { return status.load(); }
+  auto set_state (CasStatus new_status) noexcept { status.store(new_status); }
+  auto swap_state (CasStatus expected, CasStatus desired) noexcept -> bool {
+	  return status.compare_exchange_strong(expected, desired);
+  }
+  auto execute (ContentionFailureCounter &failures) noexcept -> nonstd::expected<bool, std::monostate> {
+	  (void) failures;
+	  if (loses) { return false; }
+	  executions.fetch_add(1);
+	  return true;
+  }
+
+  /// The number of executions after which the modified bit is still not set
+  int delay;
+  /// Whether the expected value of the target has been replaced by another update, thus the CAS can not take effect
+  bool loses;
+  std::atomic<int> executions{0};
+  std::atomic<CasStatus> status{CasStatus::Pending};
+};
+
+/// \brief A normalized algorithm whose commits consist of CasCount FakeCas-es
+template<std::size_t CasCount = 1>
+struct FakeAlgorithm {
+  using Input = int;
+  using Output = int;
+  using Commit = std::array<FakeCas, CasCount>;
+
+  struct Config {
+	/// The output of the fast-path. If none, the fast-path detects contention and gives up.
+	std::optional<Output> fast_path_output{0};
+	/// The output of an operation completed on the slow-path
+	Output slow_path_output{1};
+	/// The modified bit of CAS number i is set only after it has been executed more than delays[i] times
+	std::array<int, CasCount> delays{};
+	/// The CAS which loses during the first `lost_attempts` attempts of an operation (none if negative)
+	int lost_cas{-1};
+	int lost_attempts{0};
+  };
+
+  /// \brief What the simulator did with the algorithm. Shared by the copies of the algorithm.
+  struct Log {
+	std::atomic<int> attempts{0};
+	std::atomic<int> restarts{0};
+	/// The index of the CAS reported to the last wrap_up of a failed commit
+	std::atomic<int> failed_cas{-1};
+	/// The number of times each CAS of that commit was executed
+	std::array<std::atomic<int>, CasCount> failed_executions{};
+  };
+
+  explicit FakeAlgorithm (Config t_config = {}) : config{t_config} {}
+
+  auto wrap_up (const nonstd::expected<std::monostate, std::optional<int>> &executed,
+                const Commit &desc,
+                ContentionFailureCounter &contention) -> nonstd::expected<std::optional<Output>, std::monostate> {
+	  (void) contention;
+	  if (executed.has_value()) { return std::optional<Output>{config.slow_path_output}; }
+	  log->failed_cas.store(executed.error().value_or(-1));
+	  for (std::size_t i = 0; i < CasCount; ++i) { log->failed_executions[i].store(desc[i].executions.load()); }
+	  log->restarts.fetch_add(1);
+	  return std::optional<Output>{};
+  }
+
+  auto generator (const Input &input, ContentionFailureCounter &contention) -> std::optional<Commit> {
+	  (void) input;
+	  (void) contention;
+	  const auto attempt = log->attempts.fetch_add(1);
+	  return [&]<std::size_t... I> (std::index_sequence<I...>) {
+		return Commit{FakeCas{config.delays[I], static_cast<int>(I) == config.lost_cas && attempt < config.lost_attempts}...};
+	  }(std::make_index_sequence<CasCount>{});
+  }
+
+  auto fast_path (const Input &input, ContentionFailureCounter &contention) -> std::optional<Output> {
+	  (void) input;
+	  if (!config.fast_path_output.has_value()) { (void) contention.detect(); }
+	  return config.fast_path_output;
+  }
+
+  Config config;
+  std::shared_ptr<Log> log{std::make_shared<Log>()};
+};
+
+}  // namespace telamon_testsuite_fakes
+
+#endif  // TELAMON_TESTS_FAKE_ALGORITHM_HH_
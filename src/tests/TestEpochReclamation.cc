@@ -0,0 +1,85 @@
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include <telamon/EpochReclamation.hh>
+
+using namespace telamon_simulator::epoch_reclamation;
+
+namespace epoch_reclamation_testsuite {
+
+struct Tracked {
+  inline static std::atomic<int> destroyed{0};
+  ~Tracked () { destroyed.fetch_add(1); }
+};
+
+TEST(EpochReclamationTest, ActiveParticipantBlocksReclamation) {
+	EpochDomain<2> domain;
+	const auto before = Tracked::destroyed.load();
+
+	domain.enter(1);    //< A reader which may still observe the object
+	domain.enter(0);
+	domain.retire(0, new Tracked{});
+	domain.leave(0);
+
+	EXPECT_TRUE(domain.try_advance());
+	EXPECT_FALSE(domain.try_advance()); //< Participant 1 has not observed the new epoch
+	domain.enter(0);
+	domain.leave(0);
+	EXPECT_EQ(Tracked::destroyed.load(), before);
+	EXPECT_EQ(domain.retired_count(0), 1);
+
+	domain.leave(1);
+	EXPECT_TRUE(domain.try_advance());
+	domain.enter(0);
+	domain.leave(0);
+	EXPECT_EQ(Tracked::destroyed.load(), before + 1);
+	EXPECT_EQ(domain.retired_count(0), 0);
+}
+
+TEST(EpochReclamationTest, ParticipantsBeyondN) {
+	EpochDomain<1> domain;
+	const auto before = Tracked::destroyed.load();
+
+	domain.enter(5);    //< Registers participant 5 together with its segment
+	domain.enter(0);
+	domain.retire(0, new Tracked{});
+	domain.leave(0);
+
+	EXPECT_TRUE(domain.try_advance());
+	EXPECT_FALSE(domain.try_advance()); //< Participant 5 is scanned even though it is beyond N
+	EXPECT_EQ(domain.retired_count(3), 0);
+
+	domain.leave(5);
+	EXPECT_TRUE(domain.try_advance());
+	domain.enter(0);
+	domain.leave(0);
+	EXPECT_EQ(Tracked::destroyed.load(), before + 1);
+}
+
+TEST(EpochReclamationTest, NestedCriticalSections) {
+	EpochDomain<1> domain;
+	{
+		auto outer = EpochGuard<1>{domain, 0};
+		{
+			auto inner = EpochGuard<1>{domain, 0};
+		}
+		// Still inside the outer section, so the epoch cannot move twice
+		EXPECT_TRUE(domain.try_advance());
+		EXPECT_FALSE(domain.try_advance());
+	}
+	EXPECT_TRUE(domain.try_advance());
+}
+
+TEST(EpochReclamationTest, PendingObjectsFreedOnDestruction) {
+	const auto before = Tracked::destroyed.load();
+	{
+		EpochDomain<1> domain;
+		domain.enter(0);
+		domain.retire(0, new Tracked{});
+		domain.leave(0);
+	}
+	EXPECT_EQ(Tracked::destroyed.load(), before + 1);
+}
+
+}
@@ -0,0 +1,136 @@
+#include <atomic>
+#include <thread>
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nonstd/expected.hpp>
+
+#include <telamon/HazardPointers.hh>
+#include <telamon/Versioning.hh>
+
+using namespace telamon_simulator::hazard_pointers;
+
+namespace hazard_pointers_testsuite {
+
+struct Tracked {
+  inline static std::atomic<int> destroyed{0};
+  int value;
+  explicit Tracked (int t_value) : value{t_value} {}
+  ~Tracked () { destroyed.fetch_add(1); }
+};
+
+TEST(HazardPointersTest, UnprotectedObjectsAreReclaimed) {
+	auto &domain = HazardPointerDomain::global();
+	domain.reclaim();
+	const auto before = Tracked::destroyed.load();
+
+	domain.retire(new Tracked{1});
+	domain.retire(new Tracked{2});
+	domain.reclaim();
+	EXPECT_EQ(Tracked::destroyed.load(), before + 2);
+	EXPECT_EQ(domain.retired_count(), 0);
+}
+
+TEST(HazardPointersTest, ProtectedObjectIsKeptUntilCleared) {
+	auto &domain = HazardPointerDomain::global();
+	domain.reclaim();
+	const auto before = Tracked::destroyed.load();
+
+	std::atomic<Tracked *> shared{new Tracked{42}};
+	std::thread reader{[&] {
+	  auto *ptr = domain.protect(shared, HazardPointerDomain::ROTATING_SLOTS);
+	  EXPECT_TRUE(domain.is_protected(ptr));
+	}};
+	reader.join();
+	// The reader exited and released its record, thus the object is no longer protected
+
+	auto *ptr = domain.protect(shared, HazardPointerDomain::ROTATING_SLOTS);
+	domain.retire(shared.exchange(nullptr));
+	domain.reclaim();
+	EXPECT_EQ(Tracked::destroyed.load(), before);
+	EXPECT_EQ(ptr->value, 42);
+
+	domain.clear(HazardPointerDomain::ROTATING_SLOTS);
+	domain.reclaim();
+	EXPECT_EQ(Tracked::destroyed.load(), before + 1);
+}
+
+TEST(HazardPointersTest, VersionedAtomicCellsAreReclaimed) {
+	auto &domain = HazardPointerDomain::global();
+	domain.reclaim();
+
+	telamon_simulator::versioning::VersionedAtomic<int> counter{0};
+	telamon_simulator::ContentionFailureCounter failures;
+	std::array<std::thread, 8> threads;
+	for (auto &t : threads) {
+		t = std::thread{[&] {
+		  for (int i = 0; i < 1000; ++i) {
+			  while (true) {
+				  auto loaded = counter.load();
+				  if (counter.compare_exchange_strong(loaded->value, loaded->version, loaded->value + 1, failures)) { break; }
+			  }
+		  }
+		  // Bounded by the reclamation batch rather than by the number of CAS-es
+		  EXPECT_LT(HazardPointerDomain::global().retired_count(), 1000);
+		}};
+	}
+	for (auto &t : threads) { t.join(); }
+
+	EXPECT_EQ(counter.load()->value, 8000);
+	EXPECT_EQ(counter.load()->version, 8000);
+}
+
+TEST(HazardPointersTest, GuardKeepsItsSlotUntilDestroyed) {
+	auto &domain = HazardPointerDomain::global();
+	std::atomic<Tracked *> held{new Tracked{1}};
+	std::atomic<Tracked *> other{new Tracked{2}};
+	{
+		auto guard = domain.protect_guarded(held);
+		// Further loads take the other slots rather than the one owned by the guard
+		for (int i = 0; i < 2 * HazardPointerDomain::ROTATING_SLOTS; ++i) {
+			auto loaded = domain.protect_guarded(other);
+			EXPECT_EQ(loaded->value, 2);
+		}
+		EXPECT_TRUE(domain.is_protected(guard.get()));
+	}
+	EXPECT_FALSE(domain.is_protected(held.load()));
+	delete held.load();
+	delete other.load();
+}
+
+TEST(HazardPointersTest, GuardsBeyondRotatingSlots) {
+	auto &domain = HazardPointerDomain::global();
+	domain.reclaim();
+	const auto before = Tracked::destroyed.load();
+
+	constexpr int count = 3 * HazardPointerDomain::ROTATING_SLOTS;
+	std::array<std::atomic<Tracked *>, count> shared{};
+	for (int i = 0; i < count; ++i) { shared[i].store(new Tracked{i}); }
+	{
+		std::vector<HazardGuard<Tracked>> guards;
+		for (auto &ptr : shared) { guards.push_back(domain.protect_guarded(ptr)); }
+		// Every guard keeps its object, including those which took an overflow hazard
+		for (auto &ptr : shared) { domain.retire(ptr.exchange(nullptr)); }
+		domain.reclaim();
+		EXPECT_EQ(Tracked::destroyed.load(), before);
+		for (int i = 0; i < count; ++i) {
+			EXPECT_TRUE(domain.is_protected(guards[i].get()));
+			EXPECT_EQ(guards[i]->value, i);
+		}
+	}
+	domain.reclaim();
+	EXPECT_EQ(Tracked::destroyed.load(), before + count);
+
+	// The overflow hazards are released with their guards and taken again
+	std::atomic<Tracked *> again{new Tracked{count}};
+	{
+		std::vector<HazardGuard<Tracked>> guards;
+		for (int i = 0; i < count; ++i) { guards.push_back(domain.protect_guarded(again)); }
+		EXPECT_TRUE(domain.is_protected(again.load()));
+	}
+	EXPECT_FALSE(domain.is_protected(again.load()));
+	delete again.load();
+}
+
+}
@@ -1,5 +1,9 @@
 #include <thread>
+#include <algorithm>
 #include <array>
+#include <memory>
+#include <numeric>
+#include <vector>
 #include <experimental/random>
 
 #include <gtest/gtest.h>
@@ -110,4 +114,193 @@ TEST_F(HelpQueueTest, MultipleThreadsDequeue) {
 	EXPECT_FALSE(hq.peek_front().has_value());
 }
 
+TEST(HelpQueuePreallocatedTest, SlotsAreRecycled) {
+	HelpQueue<int, 4, PreallocatedNodes<2>> queue;
+	auto fun = [&] (int id) {
+	  for (int i = 0; i < 1000; ++i) {
+		  queue.push_back(id, id * 1000 + i);
+		  while (true) {
+			  auto data = queue.peek_front();
+			  if (!data.has_value() || queue.try_pop_front(data.value())) break;
+		  }
+	  }
+	};
+
+	std::array<std::thread, 4> threads;
+	for (int i = 0; i < 4; ++i)
+		threads[i] = std::thread{fun, i};
+	for (auto &t: threads)
+		t.join();
+
+	EXPECT_FALSE(queue.peek_front().has_value());
+	queue.push_back(0, 42);
+	EXPECT_EQ(queue.peek_front(), std::optional<int>{42});
+	// Slots stay in use only while they are queued or protected by a helper, never once per push
+	for (int id = 0; id < 4; ++id) {
+		EXPECT_LE(queue.overflow_slots(id), 32u);
+	}
+}
+
+TEST(HelpQueuePreallocatedTest, RingIsReusedWithoutOverflow) {
+	HelpQueue<int, 4, PreallocatedNodes<2>> queue;
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_TRUE(queue.has_free_slot(0));
+		queue.push_back(0, i);
+		EXPECT_TRUE(queue.try_pop_front(i));
+	}
+	EXPECT_EQ(queue.overflow_slots(0), 0u);
+}
+
+TEST(HelpQueuePendingTest, EnqueuersInSeveralWords) {
+	// The ids are spread over several words of the pending bitmap
+	constexpr std::array<int, 4> ids{0, 63, 64, 130};
+	constexpr int num_operations = 200;
+	HelpQueue<int, 64> queue;
+
+	std::array<std::thread, ids.size()> threads;
+	for (std::size_t i = 0; i < ids.size(); ++i) {
+		threads[i] = std::thread{[&queue, id = ids[i]] {
+		  for (int j = 0; j < num_operations; ++j) {
+			  queue.push_back(id, id * num_operations + j);
+		  }
+		}};
+	}
+	for (auto &t: threads)
+		t.join();
+
+	std::size_t size = 0;
+	while (auto data = queue.peek_front()) {
+		EXPECT_TRUE(queue.try_pop_front(data.value()));
+		++size;
+	}
+	EXPECT_EQ(size, ids.size() * num_operations);
+}
+
+TEST(HelpQueueLayoutTest, CacheAlignedOperations) {
+	constexpr int num_threads = 4;
+	constexpr int num_operations = 200;
+	static_assert(alignof(HelpQueue<int, 16, HeapNodes, CacheAlignedLayout>) == 64);
+	HelpQueue<int, 16, PreallocatedNodes<>, CacheAlignedLayout> queue;
+
+	std::array<std::thread, num_threads> threads;
+	for (int id = 0; id < num_threads; ++id) {
+		threads[id] = std::thread{[&queue, id] {
+		  for (int j = 0; j < num_operations; ++j) {
+			  queue.push_back(id, j);
+			  if (auto data = queue.peek_front()) { (void) queue.try_pop_front(data.value()); }
+		  }
+		}};
+	}
+	for (auto &t: threads)
+		t.join();
+
+	while (auto data = queue.peek_front()) {
+		EXPECT_TRUE(queue.try_pop_front(data.value()));
+	}
+	EXPECT_FALSE(queue.peek_front().has_value());
+}
+
+TEST(HelpQueueSentinelTest, QueuesOfTheSameTypeAreIndependent) {
+	HelpQueue<int> first;
+	HelpQueue<int> second;
+	first.push_back(0, 1);
+	EXPECT_FALSE(second.peek_front().has_value());
+	second.push_back(0, 2);
+	EXPECT_EQ(first.peek_front(), std::optional<int>{1});
+	EXPECT_EQ(second.peek_front(), std::optional<int>{2});
+	EXPECT_TRUE(first.try_pop_front(1));
+	EXPECT_FALSE(first.peek_front().has_value());
+	EXPECT_EQ(second.peek_front(), std::optional<int>{2});
+}
+
+TEST(HelpQueuePopFrontTest, SingleThread) {
+	HelpQueue<int> queue;
+	EXPECT_EQ(queue.pop_front(0), std::nullopt);
+	for (int i = 0; i < 10; ++i) {
+		queue.push_back(0, i);
+	}
+	EXPECT_EQ(queue.size(), std::size_t{10});
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(queue.pop_front(1), std::optional<int>{i});
+	}
+	EXPECT_EQ(queue.pop_front(1), std::nullopt);
+	EXPECT_EQ(queue.size(), std::size_t{0});
+}
+
+TEST(HelpQueuePopFrontTest, MoveOnlyElements) {
+	HelpQueue<std::unique_ptr<int>> queue;
+	queue.push_back(0, std::make_unique<int>(1));
+	queue.push_back(0, std::make_unique<int>(2));
+	auto first = queue.pop_front(0);
+	ASSERT_TRUE(first.has_value());
+	EXPECT_EQ(**first, 1);
+	auto second = queue.pop_front(0);
+	ASSERT_TRUE(second.has_value());
+	EXPECT_EQ(**second, 2);
+	EXPECT_EQ(queue.pop_front(0), std::nullopt);
+}
+
+TEST(HelpQueuePopFrontTest, EveryElementIsDequeuedOnce) {
+	constexpr int num_threads = 8;
+	constexpr int num_operations = 500;
+	HelpQueue<int> queue;
+
+	std::array<std::vector<int>, num_threads> dequeued;
+	std::array<std::thread, num_threads> threads;
+	for (int id = 0; id < num_threads; ++id) {
+		threads[id] = std::thread{[&, id] {
+		  for (int j = 0; j < num_operations; ++j) {
+			  queue.push_back(id, id * num_operations + j);
+			  if (id % 2 == 0) {
+				  if (auto data = queue.pop_front(id)) { dequeued[id].push_back(data.value()); }
+			  } else if (auto front = queue.peek_front(); front && queue.try_pop_front(front.value())) {
+				  dequeued[id].push_back(front.value());
+			  }
+		  }
+		}};
+	}
+	for (auto &t: threads)
+		t.join();
+	while (auto data = queue.pop_front(0)) {
+		dequeued[0].push_back(data.value());
+	}
+
+	std::vector<int> all;
+	for (const auto &values : dequeued) {
+		all.insert(all.end(), values.begin(), values.end());
+	}
+	std::ranges::sort(all);
+	ASSERT_EQ(all.size(), std::size_t{num_threads * num_operations});
+	for (int i = 0; i < num_threads * num_operations; ++i) {
+		EXPECT_EQ(all[i], i);
+	}
+	EXPECT_EQ(queue.size(), std::size_t{0});
+}
+
+TEST(HelpQueuePopFrontTest, ConditionalPopsSucceedOncePerElement) {
+	constexpr int num_threads = 4;
+	constexpr int num_elements = 2000;
+	HelpQueue<int> queue;
+	// Equal elements, so that every conditional pop which peeked the same head competes for it
+	for (int i = 0; i < num_elements; ++i) {
+		queue.push_back(0, 7);
+	}
+
+	std::array<int, num_threads> successes{};
+	std::array<std::thread, num_threads> threads;
+	for (int id = 0; id < num_threads; ++id) {
+		threads[id] = std::thread{[&, id] {
+		  while (auto front = queue.peek_front()) {
+			  if (queue.try_pop_front(front.value())) { ++successes[id]; }
+		  }
+		}};
+	}
+	for (auto &t: threads)
+		t.join();
+
+	EXPECT_EQ(std::accumulate(successes.begin(), successes.end(), 0), num_elements);
+	EXPECT_FALSE(queue.peek_front().has_value());
+	EXPECT_EQ(queue.size(), std::size_t{0});
+}
+
 } // helpqueue_testsuite
@@ -1,62 +1,26 @@
+#include <atomic>
 #include <optional>
 #include <ranges>
 #include <variant>
 #include <thread>
 #include <array>
+#include <vector>
 
 #include <nonstd/expected.hpp>
 #include <gtest/gtest.h>
 
 #include <telamon/WaitFreeSimulator.hh>
+#include <telamon/MultiOperation.hh>
+
+#include "FakeAlgorithm.hh"
 
 using namespace telamon_simulator;
 
 namespace telamon_simulator_testsuite {
 
-struct LF {
-  struct VersionedCas {
-	auto has_modified_bit () const noexcept -> bool { return false; }
-	auto clear_bit () const noexcept {}
-	auto state () const noexcept -> CasStatus { return CasStatus::Success; }
-	auto set_state (CasStatus new_status) noexcept { (void) new_status; }
-	auto swap_state (CasStatus expected, CasStatus desired) noexcept -> bool {
-		(void) expected;
-		(void) desired;
-		return true;
-	}
-	auto execute (ContentionFailureCounter &failures) noexcept -> nonstd::expected<bool, std::monostate> {
-		(void) failures;
-		return nonstd::make_unexpected(std::monostate{});
-	}
-  };
-
-  using LFCommit = std::ranges::single_view<VersionedCas>;
-
-  using Input = int;
-  using Output = int;
-  using Commit = LFCommit;
-
-  auto wrap_up (const nonstd::expected<std::monostate, std::optional<int>> &executed,
-                const LF::Commit &desc,
-                ContentionFailureCounter &contention) -> nonstd::expected<std::optional<LF::Output>, std::monostate> {
-	  (void) desc;
-	  (void) executed;
-	  (void) contention;
-	  return {};
-  }
-
-  auto generator (const LF::Input &input, ContentionFailureCounter &contention) -> std::optional<LF::Commit> {
-	  (void) input;
-	  (void) contention;
-	  return std::optional<LF::Commit>{};
-  }
-
-  auto fast_path (const LF::Input &inp, ContentionFailureCounter &contention) -> std::optional<LF::Output> {
-	  (void) inp;
-	  (void) contention;
-	  return LF::Output{};
-  }
-};
+/// An algorithm whose fast-path always succeeds
+using LF = telamon_testsuite_fakes::FakeAlgorithm<>;
+using telamon_testsuite_fakes::FakeCas;
 
 class TelamonSimulatorTest : public ::testing::Test {
  protected:
@@ -71,6 +35,94 @@ TEST_F(TelamonSimulatorTest, NormalizedLockFreeConcept) {
 	EXPECT_TRUE(true);
 }
 
+TEST_F(TelamonSimulatorTest, FixedSizeCommitConcept) {
+	EXPECT_TRUE(FixedSizeCommits<LF::Commit>);
+	EXPECT_TRUE((FixedSizeCommits<std::array<FakeCas, 3>>));
+	// Committed as ranges
+	EXPECT_FALSE(FixedSizeCommits<std::ranges::single_view<FakeCas>>);
+	EXPECT_FALSE(FixedSizeCommits<std::vector<FakeCas>>);
+}
+
+TEST_F(TelamonSimulatorTest, LostCasRestartsTheOperation) {
+	using Fake = telamon_testsuite_fakes::FakeAlgorithm<3>;
+	auto fake = Fake{{.fast_path_output = std::nullopt, .lost_cas = 1, .lost_attempts = 1}};
+	WaitFreeSimulatorHandle<Fake, 2> handle{fake};
+	EXPECT_EQ(handle.submit(Fake::Input{}, true), 1);
+
+	// The unrolled commit stops at the second CAS, reports it and wrap_up restarts the operation
+	EXPECT_EQ(fake.log->attempts.load(), 2);
+	EXPECT_EQ(fake.log->restarts.load(), 1);
+	EXPECT_EQ(fake.log->failed_cas.load(), 1);
+	EXPECT_EQ(fake.log->failed_executions[0].load(), 1);
+	EXPECT_EQ(fake.log->failed_executions[1].load(), 0);
+	EXPECT_EQ(fake.log->failed_executions[2].load(), 0);
+}
+
+TEST_F(TelamonSimulatorTest, LostSingleCas) {
+	auto fake = LF{{.fast_path_output = std::nullopt, .lost_cas = 0, .lost_attempts = 2}};
+	WaitFreeSimulatorHandle<LF, 2> handle{fake};
+	EXPECT_EQ(handle.submit(LF::Input{}, true), 1);
+
+	EXPECT_EQ(fake.log->attempts.load(), 3);
+	EXPECT_EQ(fake.log->restarts.load(), 2);
+	EXPECT_EQ(fake.log->failed_cas.load(), 0);
+}
+
+TEST_F(TelamonSimulatorTest, MultiOperationHelpsOtherKind) {
+	using First = telamon_testsuite_fakes::FakeAlgorithm<1>;
+	using Second = telamon_testsuite_fakes::FakeAlgorithm<2>;
+	using Ops = MultiOperation<First, Second>;
+	auto first = First{{.fast_path_output = std::nullopt, .slow_path_output = 1}};
+	auto second = Second{{.fast_path_output = std::nullopt, .slow_path_output = 2}};
+	WaitFreeSimulatorHandle<Ops, 2> origin_handle{Ops{first, second}};
+	auto other_handle = origin_handle.fork().value();
+
+	// The operation of the first kind stays in the help queue, and is completed by the owner of the second kind before it
+	// runs its own operation
+	auto token = origin_handle.submit_async(Ops::make_input<First>(0));
+	EXPECT_EQ(Ops::output_of<Second>(other_handle.submit(Ops::make_input<Second>(0), true)), 2);
+	EXPECT_TRUE(token.ready());
+	EXPECT_EQ(Ops::output_of<First>(token.get()), 1);
+	EXPECT_EQ(first.log->attempts.load(), 1);
+	EXPECT_EQ(second.log->attempts.load(), 1);
+	other_handle.retire();
+}
+
+TEST_F(TelamonSimulatorTest, MultiOperationConcurrentKinds) {
+	using First = telamon_testsuite_fakes::FakeAlgorithm<1>;
+	using Second = telamon_testsuite_fakes::FakeAlgorithm<2>;
+	using Ops = MultiOperation<First, Second>;
+	constexpr int nums = 64;
+	auto first = First{{.fast_path_output = std::nullopt, .slow_path_output = 1, .delays = {1}}};
+	auto second = Second{{.fast_path_output = std::nullopt, .slow_path_output = 2, .delays = {0, 1}}};
+	WaitFreeSimulatorHandle<Ops, ConcurrentTasks> origin_handle{Ops{first, second}, 1};
+
+	// Threads of both kinds run on the slow-path at once, thus they help each other's operations
+	std::array<std::thread, ConcurrentTasks - 1> tasks;
+	for (int id = 0; auto &t: tasks) {
+		t = std::thread{[&] (int id) {
+		  auto handle_opt = origin_handle.fork();
+		  if (!handle_opt.has_value()) return;
+		  auto handle = handle_opt.value();
+		  for (int i = 0; i < nums; ++i) {
+			  if (id % 2 == 0) {
+				  EXPECT_EQ(Ops::output_of<First>(handle.submit(Ops::make_input<First>(i), true)), 1);
+			  } else {
+				  EXPECT_EQ(Ops::output_of<Second>(handle.submit(Ops::make_input<Second>(i), true)), 2);
+			  }
+		  }
+		  handle.retire();
+		}, id};
+		++id;
+	}
+
+	for (auto &t: tasks) {
+		t.join();
+	}
+	EXPECT_GE(first.log->attempts.load(), nums * static_cast<int>(tasks.size()) / 2);
+	EXPECT_GE(second.log->attempts.load(), nums * static_cast<int>(tasks.size()) / 2);
+}
+
 TEST_F(TelamonSimulatorTest, HandleSimulatorConstruction) {
 	WaitFreeSimulatorHandle<LF, 2> origin_handle{algorithm};
 
@@ -80,6 +132,46 @@ TEST_F(TelamonSimulatorTest, HandleSimulatorConstruction) {
 	auto forth_handle = origin_handle.fork().value();
 }
 
+TEST_F(TelamonSimulatorTest, ParticipantsBeyondN) {
+	// The state of the simulator grows by segments of 2 ids
+	WaitFreeSimulatorHandle<LF, 2> origin_handle{algorithm, 1, 7};
+
+	std::vector<WaitFreeSimulatorHandle<LF, 2>> handles;
+	for (int i = 1; i < 7; ++i) {
+		handles.push_back(origin_handle.fork().value());
+	}
+	EXPECT_TRUE(!origin_handle.fork().has_value());
+	for (auto &handle : handles) {
+		EXPECT_EQ(handle.submit(LF::Input{}), LF::Output{});
+		handle.help();
+	}
+	handles.back().retire();
+	handles.pop_back();
+	EXPECT_TRUE(origin_handle.fork().has_value());
+}
+
+TEST_F(TelamonSimulatorTest, ConcurrentForks) {
+	// More threads than ids, each keeping its handle until every thread has tried to fork
+	WaitFreeSimulatorHandle<LF, 2> origin_handle{algorithm, 1, 70};
+	std::atomic<int> forked{0};
+	std::atomic<int> done{0};
+	std::array<std::thread, 80> tasks;
+	for (auto &t: tasks) {
+		t = std::thread{[&] {
+		  auto handle_opt = origin_handle.fork();
+		  if (handle_opt.has_value()) { forked.fetch_add(1); }
+		  done.fetch_add(1);
+		  while (done.load() < static_cast<int>(tasks.size())) { std::this_thread::yield(); }
+		  if (handle_opt.has_value()) { handle_opt.value().retire(); }
+		}};
+	}
+	for (auto &t: tasks) {
+		t.join();
+	}
+	EXPECT_EQ(forked.load(), 69);
+	EXPECT_TRUE(origin_handle.fork().has_value());
+}
+
 TEST_F(TelamonSimulatorTest, Helping) {
 	WaitFreeSimulatorHandle<LF, ConcurrentTasks> origin_handle{algorithm};
 	std::array<std::thread, ConcurrentTasks - 1> tasks;
@@ -115,4 +207,29 @@ TEST_F(TelamonSimulatorTest, SubmittingOperations) {
 	}
 }
 
+TEST_F(TelamonSimulatorTest, ContentionPolicy) {
+	using Policy = ContentionPolicy<1, 5, BackoffKind::Exponential, 2, 64>;
+	auto counter = Policy::make_counter();
+	EXPECT_FALSE(counter.detect());
+	counter.backoff();
+	EXPECT_TRUE(counter.detect());
+	counter.backoff();
+
+	WaitFreeSimulatorHandle<LF, ConcurrentTasks, Policy> origin_handle{algorithm};
+	std::array<std::thread, ConcurrentTasks - 1> tasks;
+	for (auto &t: tasks) {
+		t = std::thread{[&] {
+		  auto handle_opt = origin_handle.fork();
+		  if (!handle_opt.has_value()) return;
+		  auto handle = handle_opt.value();
+		  EXPECT_EQ(handle.submit(LF::Input{}), LF::Output{});
+		  handle.retire();
+		}};
+	}
+
+	for (auto &t: tasks) {
+		t.join();
+	}
+}
+
 }  // namespace telamon_simulator_testsuite
@@ -0,0 +1,148 @@
+#define TEL_STATISTICS
+
+#include <array>
+#include <latch>
+#include <optional>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <nonstd/expected.hpp>
+#include <gtest/gtest.h>
+
+#include <telamon/WaitFreeSimulator.hh>
+
+#include "FakeAlgorithm.hh"
+
+using namespace telamon_simulator;
+
+namespace telamon_statistics_testsuite {
+
+using Fake = telamon_testsuite_fakes::FakeAlgorithm<2>;
+
+/// An algorithm whose fast-path always gives up and whose second CAS only takes effect when it is executed again
+const auto SLOW = Fake::Config{.fast_path_output = std::nullopt, .delays = {0, 1}};
+/// An algorithm whose fast-path always succeeds
+const auto FAST = Fake::Config{.fast_path_output = 0, .delays = {0, 1}};
+
+TEST(StatisticsTest, FastPath) {
+	auto handle = WaitFreeSimulatorHandle<Fake, 4>{Fake{FAST}};
+	for (int i = 0; i < 10; ++i) { EXPECT_EQ(handle.submit(i), 0); }
+
+	const auto stats = handle.statistics();
+	EXPECT_EQ(stats.fast_path_attempts, 10);
+	EXPECT_EQ(stats.fast_path_successes, 10);
+	EXPECT_EQ(stats.contention_detections, 0);
+	EXPECT_EQ(stats.slow_path_entries, 0);
+}
+
+TEST(StatisticsTest, SlowPath) {
+	using Policy = ContentionPolicy<8, 2>;
+	auto handle = WaitFreeSimulatorHandle<Fake, 4, Policy>{Fake{SLOW}};
+	EXPECT_EQ(handle.submit(0), 1);
+
+	const auto stats = handle.statistics();
+	EXPECT_EQ(stats.fast_path_attempts, 2);
+	EXPECT_EQ(stats.fast_path_successes, 0);
+	// Each attempt is detected once by the algorithm and once by the simulator
+	EXPECT_EQ(stats.contention_detections, 4);
+	EXPECT_EQ(stats.slow_path_entries, 1);
+	// The modified bit of the second CAS is not set the first time, thus the commit is retried rather than failed
+	EXPECT_EQ(stats.help_count(HelpedState::PreCas), 1);
+	EXPECT_EQ(stats.help_count(HelpedState::ExecutingCas), 2);
+	EXPECT_EQ(stats.help_count(HelpedState::PostCas), 1);
+	EXPECT_EQ(stats.commit_failure_count(0), 0);
+	EXPECT_EQ(stats.commit_failure_count(1), 0);
+	EXPECT_EQ(stats.failed_box_cas, 0);
+}
+
+TEST(StatisticsTest, LostCas) {
+	auto config = SLOW;
+	config.lost_cas = 1;
+	config.lost_attempts = 1;
+	auto handle = WaitFreeSimulatorHandle<Fake, 4>{Fake{config}};
+	EXPECT_EQ(handle.submit(0, true), 1);
+
+	// The first attempt fails at the second CAS and is restarted
+	const auto stats = handle.statistics();
+	EXPECT_EQ(stats.help_count(HelpedState::PreCas), 2);
+	EXPECT_EQ(stats.help_count(HelpedState::PostCas), 2);
+	EXPECT_EQ(stats.commit_failure_count(0), 0);
+	EXPECT_EQ(stats.commit_failure_count(1), 1);
+}
+
+TEST(StatisticsTest, PathPredictorSkipsFastPath) {
+	using Policy = ContentionPolicy<8, 2>;
+	auto handle = WaitFreeSimulatorHandle<Fake, 4, Policy>{Fake{SLOW}};
+	handle.set_path_predictor(PathPredictor{});
+	// The estimate crosses the threshold after three failed fast-paths
+	for (int i = 0; i < 3; ++i) { EXPECT_EQ(handle.submit(i), 1); }
+	EXPECT_EQ(handle.statistics().fast_path_skips, 0);
+	EXPECT_EQ(handle.submit(3), 1);
+	EXPECT_EQ(handle.statistics().fast_path_skips, 1);
+
+	constexpr int num_operations = 100;
+	for (int i = 4; i < num_operations; ++i) { EXPECT_EQ(handle.submit(i), 1); }
+	const auto stats = handle.statistics();
+	EXPECT_EQ(stats.slow_path_entries, num_operations);
+	// The skipped operations do not try the fast-path, but the fast-path is still tried once in a while
+	EXPECT_EQ(stats.fast_path_attempts, 2 * (num_operations - stats.fast_path_skips));
+	EXPECT_GT(stats.fast_path_skips, num_operations / 2);
+	EXPECT_LT(stats.fast_path_skips, num_operations);
+
+	// A handle without a predictor always tries the fast-path
+	auto forked = handle.fork().value();
+	forked.set_path_predictor(std::nullopt);
+	for (int i = 0; i < 10; ++i) { EXPECT_EQ(forked.submit(i), 1); }
+	EXPECT_EQ(forked.statistics().fast_path_skips, 0);
+	forked.retire();
+}
+
+TEST(StatisticsTest, PathPredictorDecays) {
+	auto predictor = PathPredictor{};
+	for (int i = 0; i < 10; ++i) { predictor.record(true); }
+	EXPECT_TRUE(predictor.skip_fast_path());
+	int skipped = 0;
+	while (predictor.skip_fast_path()) {
+		predictor.record_skip();
+		++skipped;
+	}
+	EXPECT_GT(skipped, 0);
+	for (int i = 0; i < 10; ++i) { predictor.record(false); }
+	EXPECT_FALSE(predictor.skip_fast_path());
+	EXPECT_LT(predictor.estimate, PathPredictor::SCALE / 16);
+}
+
+TEST(StatisticsTest, SnapshotAddsUpHandles) {
+	constexpr int num_threads = 4;
+	constexpr int num_operations = 100;
+	auto origin = WaitFreeSimulatorHandle<Fake, num_threads + 1>{Fake{FAST}};
+	// Forked up-front, so that a failed fork fails the test rather than leaving the others waiting at the latch
+	std::vector<decltype(origin)> handles;
+	for (int i = 0; i < num_threads; ++i) {
+		auto handle_opt = origin.fork();
+		ASSERT_TRUE(handle_opt.has_value());
+		handles.push_back(handle_opt.value());
+	}
+	// The counters belong to ids, thus no handle retires before the others are done
+	std::latch done{num_threads};
+
+	std::array<std::thread, num_threads> threads;
+	for (int id = 0; id < num_threads; ++id) {
+		threads[id] = std::thread{[&, id] {
+		  auto &handle = handles[id];
+		  for (int i = 0; i < num_operations; ++i) { (void) handle.submit(i); }
+		  done.arrive_and_wait();
+		  EXPECT_EQ(handle.statistics().fast_path_successes, num_operations);
+		  handle.retire();
+		}};
+	}
+	for (auto &t : threads) t.join();
+
+	const auto total = origin.snapshot();
+	EXPECT_EQ(total.fast_path_attempts, num_threads * num_operations);
+	EXPECT_EQ(total.fast_path_successes, num_threads * num_operations);
+	EXPECT_EQ(origin.statistics().fast_path_attempts, 0);
+}
+
+}  // namespace telamon_statistics_testsuite
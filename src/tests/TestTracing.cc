@@ -0,0 +1,97 @@
+#define TEL_TRACING
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <thread>
+#include <variant>
+
+#include <nonstd/expected.hpp>
+#include <gtest/gtest.h>
+
+#include <telamon/WaitFreeSimulator.hh>
+
+#include "FakeAlgorithm.hh"
+
+using namespace telamon_simulator;
+using tracing::TraceEvent;
+using tracing::TraceEventKind;
+
+namespace telamon_tracing_testsuite {
+
+using Fake = telamon_testsuite_fakes::FakeAlgorithm<>;
+
+/// An algorithm whose fast-path always gives up and whose commit always succeeds
+const auto SLOW = Fake::Config{.fast_path_output = std::nullopt};
+
+auto count (const std::vector<TraceEvent> &events, const TraceEventKind kind) -> long {
+	return std::ranges::count_if(events, [&] (const TraceEvent &event) { return event.kind == kind; });
+}
+
+TEST(TracingTest, SlowPathTimeline) {
+	auto collector = tracing::TraceCollector{};
+	auto handle = WaitFreeSimulatorHandle<Fake, 4, ContentionPolicy<8, 2>>{Fake{SLOW}};
+	EXPECT_EQ(handle.submit(0), 1);
+	collector.stop();
+
+	const auto events = collector.events();
+	EXPECT_EQ(count(events, TraceEventKind::FastPathAttempt), 2);
+	EXPECT_EQ(count(events, TraceEventKind::FastPathAbandoned), 1);
+	EXPECT_EQ(count(events, TraceEventKind::SlowPathEnqueued), 1);
+	EXPECT_EQ(count(events, TraceEventKind::QueuePush), 1);
+	// PreCas -> ExecutingCas -> PostCas -> Completed
+	EXPECT_EQ(count(events, TraceEventKind::Transition), 3);
+	EXPECT_EQ(count(events, TraceEventKind::SlowPathCompleted), 1);
+
+	// The events of a single thread are in order
+	EXPECT_TRUE(std::ranges::is_sorted(events, {}, &TraceEvent::timestamp));
+	const auto enqueued = std::ranges::find(events, TraceEventKind::SlowPathEnqueued, &TraceEvent::kind);
+	const auto completed = std::ranges::find(events, TraceEventKind::SlowPathCompleted, &TraceEvent::kind);
+	EXPECT_LT(enqueued, completed);
+	EXPECT_EQ(tracing::TraceRecorder::global().dropped(), 0);
+}
+
+TEST(TracingTest, ThreadsHaveSeparateBuffers) {
+	auto collector = tracing::TraceCollector{};
+	auto origin = WaitFreeSimulatorHandle<Fake, 4>{Fake{SLOW}};
+
+	std::array<std::thread, 2> threads;
+	for (auto &t : threads) {
+		t = std::thread{[&] {
+		  auto handle = origin.fork().value();
+		  for (int i = 0; i < 10; ++i) { (void) handle.submit(i, true); }
+		  handle.retire();
+		}};
+	}
+	for (auto &t : threads) t.join();
+	collector.stop();
+
+	const auto events = collector.events();
+	EXPECT_EQ(count(events, TraceEventKind::SlowPathCompleted), 20);
+	for (const auto &event : events) {
+		if (event.kind != TraceEventKind::SlowPathCompleted) { continue; }
+		// Completions are observed by the owners, each of which records into the buffer of its own thread
+		const auto same_owner = [&] (const TraceEvent &other) {
+		  return other.kind == TraceEventKind::SlowPathCompleted && other.id == event.id;
+		};
+		EXPECT_TRUE(std::ranges::all_of(events | std::views::filter(same_owner), [&] (const TraceEvent &other) {
+		  return other.thread == event.thread;
+		}));
+	}
+}
+
+TEST(TracingTest, ChromeTraceFormat) {
+	const auto events = std::vector<TraceEvent>{
+		TraceEvent{.timestamp = 1500, .operation = 16, .id = 1, .arg = 2, .thread = 3, .kind = TraceEventKind::Help}
+	};
+	auto os = std::ostringstream{};
+	tracing::write_chrome_trace(os, events);
+	const auto json = os.str();
+	EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+	EXPECT_NE(json.find("{\"name\":\"Help\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":3,\"ts\":1.500,"
+	                    "\"args\":{\"op\":16,\"id\":1,\"arg\":2}}"), std::string::npos);
+}
+
+}  // namespace telamon_tracing_testsuite
@@ -82,4 +82,70 @@ TEST(VersioningTest, CoreFunctionality) {
 	EXPECT_DOUBLE_EQ(v_with_meta == 3, meta == false);
 }
 
+TEST(VersioningTest, InlineDoubleWord) {
+	struct Mark {
+	  bool marked = false;
+	  bool operator== (const Mark &rhs) const { return marked == rhs.marked; }
+	};
+	using InlineCounter = VersionedAtomic<int, Mark, InlineDoubleWord>;
+	static_assert(sizeof(InlineCounter) <= 32, "Inline representation should not reference a heap cell.");
+
+	InlineCounter counter{0};
+	telamon_simulator::ContentionFailureCounter failure_counter;
+	std::array<std::thread, 16> threads;
+	for (auto &t: threads) {
+		t = std::thread{[&] {
+		  for (int i = 0; i < 1000; ++i) {
+			  while (true) {
+				  auto loaded = counter.load();
+				  if (counter.compare_exchange_strong(loaded->value, loaded->version, loaded->value + 1, loaded->meta, failure_counter)) break;
+			  }
+		  }
+		}};
+	}
+	for (auto &t: threads) {
+		t.join();
+	}
+	EXPECT_EQ(counter.load()->value, 16000);
+	EXPECT_EQ(counter.version(), 16000);
+
+	// A stale version is rejected even though the value matches
+	EXPECT_FALSE(counter.compare_exchange_strong(16000, 0, 1, Mark{true}, failure_counter));
+	EXPECT_TRUE(counter.compare_exchange_strong(16000, 16000, 16000, Mark{true}, failure_counter));
+	auto[value, marked] = counter.transform([] (auto value, auto version, Mark meta) {
+	  return std::make_pair(value, meta.marked);
+	});
+	EXPECT_EQ(value, 16000);
+	EXPECT_TRUE(marked);
+	EXPECT_EQ(counter.version(), 16001);
+}
+
+TEST(VersioningTest, PackedWord) {
+	struct Mark {
+	  bool marked = false;
+	  bool operator== (const Mark &rhs) const { return marked == rhs.marked; }
+	};
+	using PackedLink = VersionedAtomic<int *, Mark, PackedWord>;
+	static_assert(sizeof(std::atomic<uint64_t>) + sizeof(std::atomic<bool>) <= sizeof(PackedLink) && sizeof(PackedLink) <= 16);
+
+	std::array<int, 2> targets{1, 2};
+	PackedLink link{&targets[0]};
+	telamon_simulator::ContentionFailureCounter failure_counter;
+	EXPECT_TRUE(link.compare_exchange_strong(&targets[0], 0, &targets[0], Mark{true}, failure_counter));
+	EXPECT_EQ(link.load()->value, &targets[0]);
+	EXPECT_TRUE(link.load()->meta.marked);
+	EXPECT_EQ(link.version(), 1);
+
+	// The version is kept modulo 2^16
+	for (int i = 0; i < (1 << 16) - 1; ++i) {
+		link.store(&targets[(i + 1) % 2]);
+	}
+	EXPECT_EQ(link.load()->value, &targets[1]);
+	EXPECT_TRUE(link.load()->meta.marked);
+	EXPECT_EQ(link.version(), 0);
+	EXPECT_TRUE(link.compare_exchange_strong(&targets[1], 1 << 16, &targets[0], Mark{false}, failure_counter));
+	EXPECT_EQ(*link.load()->value, 1);
+	EXPECT_FALSE(link.load()->meta.marked);
+}
+
 }
@@ -0,0 +1,106 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <variant>
+
+#include <benchmark/benchmark.h>
+
+#include <telamon/WaitFreeSimulator.hh>
+#include <telamon/Versioning.hh>
+
+namespace tsim = telamon_simulator;
+
+/// \brief Increments of a counter, each committed with a single CAS. With `Fixed` the commit is a std::array and takes the
+/// 	   single-CAS path of the simulator, otherwise it is a range and takes the generic per-CAS path.
+template<bool Fixed>
+class Increment {
+ public:
+  using Counter = tsim::versioning::VersionedAtomic<uint64_t, bool, tsim::versioning::InlineDoubleWord>;
+
+  class CasDescriptor {
+   public:
+	CasDescriptor (Counter &t_target, uint64_t t_expected) : m_target{&t_target}, m_expected{t_expected} {}
+
+	CasDescriptor (const CasDescriptor &rhs)
+		: m_target{rhs.m_target},
+		  m_expected{rhs.m_expected},
+		  m_state{rhs.m_state.load()} {}
+
+   public:
+	[[nodiscard]] auto has_modified_bit () const noexcept -> bool { return m_target->has_modified_bit(); }
+
+	auto clear_bit () noexcept { m_target->clear_modified_bit(); }
+
+	[[nodiscard]] auto state () const noexcept -> tsim::CasStatus { return m_state.load(); }
+
+	auto set_state (tsim::CasStatus t_state) noexcept { m_state.store(t_state); }
+
+	[[nodiscard]] auto swap_state (tsim::CasStatus expected, tsim::CasStatus desired) noexcept -> bool {
+		return m_state.compare_exchange_strong(expected, desired);
+	}
+
+	[[nodiscard]] auto execute (tsim::ContentionFailureCounter &failures) noexcept -> nonstd::expected<bool, std::monostate> {
+		return m_target->compare_exchange_strong(m_expected, std::nullopt, m_expected + 1, false, failures);
+	}
+
+	[[nodiscard]] auto desired () const noexcept -> uint64_t { return m_expected + 1; }
+
+   private:
+	Counter *m_target;
+	uint64_t m_expected;
+	std::atomic<tsim::CasStatus> m_state{tsim::CasStatus::Pending};
+  };
+
+  using Input = int;
+  using Output = uint64_t;
+  using Commit = std::conditional_t<Fixed, std::array<CasDescriptor, 1>, std::ranges::single_view<CasDescriptor>>;
+
+  explicit Increment (Counter &t_counter) : m_counter{&t_counter} {}
+
+ public:
+  auto generator (const Input &inp, tsim::ContentionFailureCounter &failures) -> std::optional<Commit> {
+	  (void) inp;
+	  (void) failures;
+	  return Commit{CasDescriptor{*m_counter, m_counter->load()->value}};
+  }
+
+  auto wrap_up (const nonstd::expected<std::monostate, std::optional<int>> &executed, const Commit &desc, tsim::ContentionFailureCounter &failures)
+  -> nonstd::expected<std::optional<Output>, std::monostate> {
+	  (void) failures;
+	  if (!executed.has_value()) { return std::optional<Output>{}; }
+	  return std::make_optional(std::ranges::begin(desc)->desired());
+  }
+
+  auto fast_path (const Input &inp, tsim::ContentionFailureCounter &failures) -> std::optional<Output> {
+	  (void) inp;
+	  (void) failures;
+	  return std::nullopt;
+  }
+
+ private:
+  Counter *m_counter;
+};
+
+/// \brief Increments run on the slow-path by a single thread, thus every commit succeeds at its first execution and the
+/// 	   difference between the two instances is the commit path
+template<bool Fixed>
+static void BM_SlowPathCommit (benchmark::State &state) {
+	typename Increment<Fixed>::Counter counter{uint64_t{0}};
+	auto handle = tsim::WaitFreeSimulatorHandle<Increment<Fixed>, 4>{Increment<Fixed>{counter}};
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(handle.submit(0, true));
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+// std::array<CasDescriptor, 1>
+BENCHMARK_TEMPLATE(BM_SlowPathCommit, true);
+// std::ranges::single_view<CasDescriptor>
+BENCHMARK_TEMPLATE(BM_SlowPathCommit, false);
+
+BENCHMARK_MAIN();
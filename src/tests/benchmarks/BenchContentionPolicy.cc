@@ -0,0 +1,70 @@
+#include <thread>
+#include <vector>
+#include <ranges>
+using namespace std::ranges::views;
+
+#include <benchmark/benchmark.h>
+
+#include <samples/NormalizedLinkedList.hh>
+#include <telamon/WaitFreeSimulator.hh>
+
+using namespace normalizedlinkedlist;
+
+/// \brief Concurrent insertions of interleaved keys, so that the threads contend on the same links.
+/// 	   Instantiated for several contention policies in order to tune the thresholds and the backoff for a given machine.
+template<typename Policy>
+static void BM_ContendedInsertions (benchmark::State &state) {
+	const int num_threads = static_cast<int>(state.range(0));
+	const int num_operations = static_cast<int>(state.range(1));
+	constexpr int max_handles = 65;
+
+	for (auto _ : state) {
+		LinkedList<int> ll;
+		auto insertion = typename decltype(ll)::NormalizedInsert{ll};
+		auto insertion_sim = tsim::WaitFreeSimulatorHandle<decltype(insertion), max_handles, Policy>{insertion};
+
+		auto churn = [&] (int id) {
+		  auto inserter = insertion_sim.fork();
+		  if (!inserter.has_value()) { return; }
+		  // Thread `id` inserts id, id + num_threads, ... thus neighbouring keys belong to different threads
+		  for (int i : iota(0, num_operations)) {
+			  benchmark::DoNotOptimize(inserter.value().submit(i * num_threads + id));
+		  }
+		  inserter.value().retire();
+		};
+
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(churn, id);
+		for (auto &t: threads) t.join();
+	}
+
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_threads * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+using tsim::BackoffKind;
+using tsim::ContentionPolicy;
+
+static void sweep_threads (benchmark::internal::Benchmark *bench) {
+	const auto hw = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+	for (int threads = 1; threads <= std::min(2 * hw, 64); threads *= 2) {
+		bench->Args({threads, 1000});
+	}
+}
+
+#define TEL_POLICY_BENCHMARK(...) \
+    BENCHMARK_TEMPLATE(BM_ContendedInsertions, __VA_ARGS__)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime()
+
+// The original hard-coded behaviour
+TEL_POLICY_BENCHMARK(tsim::DefaultContentionPolicy);
+// Give up on the fast-path sooner or later
+TEL_POLICY_BENCHMARK(ContentionPolicy<1, 1>);
+TEL_POLICY_BENCHMARK(ContentionPolicy<8, 8>);
+// Backoff strategies
+TEL_POLICY_BENCHMARK(ContentionPolicy<2, 3, BackoffKind::Pause, 32>);
+TEL_POLICY_BENCHMARK(ContentionPolicy<2, 3, BackoffKind::Exponential, 4, 1024>);
+TEL_POLICY_BENCHMARK(ContentionPolicy<8, 8, BackoffKind::Exponential, 16, 4096>);
+// The owner of an operation on the slow-path parks instead of spinning
+TEL_POLICY_BENCHMARK(tsim::ParkingContentionPolicy);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <telamon/HelpQueue.hh>
+#include "PerfCounters.hh"
+
+using namespace helpqueue;
+
+constexpr int MaxThreads = 32;
+
+/// \brief Each thread enqueues, peeks and dequeues, the way the simulator uses the help queue on the slow path. Reports the
+/// 	   cache misses per operation summed over the threads, so that the packed and the cache-aligned layouts can be
+/// 	   compared for every number of threads.
+template<typename Layout>
+static void BM_HelpQueueLayout (benchmark::State &state) {
+	const int num_threads = static_cast<int>(state.range(0));
+	const int num_operations = static_cast<int>(state.range(1));
+	static HelpQueue<int, MaxThreads, PreallocatedNodes<>, Layout> hq;
+
+	std::atomic<uint64_t> cache_misses{0};
+	std::atomic<bool> counted{true};
+	auto work = [&] (int id) {
+	  telamon_benchmarks::PerfCounter misses{PERF_COUNT_HW_CACHE_MISSES};
+	  misses.start();
+	  for (int i = 0; i < num_operations; ++i) {
+		  hq.push_back(id, i);
+		  if (auto front = hq.peek_front(); front.has_value()) {
+			  (void) hq.try_pop_front(front.value());
+		  }
+	  }
+	  misses.stop();
+	  cache_misses.fetch_add(misses.read_value());
+	  if (!misses.available()) { counted.store(false); }
+	};
+
+	for (auto _ : state) {
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(work, id);
+		for (auto &t : threads) t.join();
+	}
+
+	const auto ops = static_cast<double>(state.iterations()) * num_threads * num_operations;
+	state.counters["ops"] = benchmark::Counter(ops, benchmark::Counter::kIsRate);
+	if (counted.load()) {
+		state.counters["cache_misses_per_op"] = static_cast<double>(cache_misses.load()) / ops;
+	} else {
+		state.SetLabel("perf counters unavailable");
+	}
+}
+
+static void sweep_threads (benchmark::internal::Benchmark *bench) {
+	for (int threads = 1; threads <= 16; threads *= 2) {
+		bench->Args({threads, 10000});
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_HelpQueueLayout, PackedLayout)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HelpQueueLayout, CacheAlignedLayout)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,49 @@
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <samples/NormalizedLinkedList.hh>
+#include <telamon/WaitFreeSimulator.hh>
+
+using namespace normalizedlinkedlist;
+
+/// \brief Threads which repeatedly fork a handle and retire it right away, as short-lived worker tasks do
+static void BM_ForkRetire (benchmark::State &state) {
+	const int num_threads = static_cast<int>(state.range(0));
+	const int num_forks = static_cast<int>(state.range(1));
+
+	LinkedList<int> ll;
+	auto insertion = typename decltype(ll)::NormalizedInsert{ll};
+	using Handle = tsim::WaitFreeSimulatorHandle<decltype(insertion), 64>;
+	auto origin = Handle{insertion};
+
+	for (auto _ : state) {
+		auto churn = [&] {
+		  for (int i = 0; i < num_forks; ++i) {
+			  auto handle = origin.fork();
+			  if (handle.has_value()) {
+				  handle.value().retire();
+			  }
+		  }
+		};
+
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(churn);
+		for (auto &t: threads) t.join();
+	}
+
+	state.counters["forks"] = benchmark::Counter(static_cast<double>(num_threads * num_forks), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void sweep_threads (benchmark::internal::Benchmark *bench) {
+	const auto hw = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+	for (int threads = 1; threads <= std::min(2 * hw, 63); threads *= 2) {
+		bench->Args({threads, 10000});
+	}
+}
+
+BENCHMARK(BM_ForkRetire)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
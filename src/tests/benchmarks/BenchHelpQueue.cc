@@ -0,0 +1,154 @@
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+
+#include <telamon/HelpQueue.hh>
+
+using namespace helpqueue;
+
+constexpr int MaxThreads = 32;
+
+/// \brief Each thread enqueues an element with its own id and then dequeues whatever is at the front, the way the simulator
+/// 	   uses the help queue on the slow path.
+template<typename Storage>
+static void BM_PushPeekPop (benchmark::State &state) {
+	const size_t num_threads = state.range(0);
+	const size_t num_operations = state.range(1);
+	static HelpQueue<int, MaxThreads, Storage> hq;
+
+	auto work = [&] (int id) {
+	  for (size_t i = 0; i < num_operations; ++i) {
+		  hq.push_back(id, static_cast<int>(i));
+		  if (auto front = hq.peek_front(); front.has_value()) {
+			  (void) hq.try_pop_front(front.value());
+		  }
+	  }
+	};
+
+	for (auto _ : state) {
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(work, id);
+		for (auto &t : threads) t.join();
+	}
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_threads * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_PushPeekPop, HeapNodes)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+	->Args({1, 10000})
+	->Args({2, 10000})
+	->Args({4, 10000})
+	->Args({8, 10000})
+	->Args({16, 10000});
+
+BENCHMARK_TEMPLATE(BM_PushPeekPop, PreallocatedNodes<>)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+	->Args({1, 10000})
+	->Args({2, 10000})
+	->Args({4, 10000})
+	->Args({8, 10000})
+	->Args({16, 10000});
+
+/// \brief A single thread enqueues and dequeues while `range(0)` enqueuers are registered. Picking the phase of an enqueue
+/// 	   does not depend on the number of enqueuers, thus what is left of the growth comes from the helping scan.
+static void BM_PushPopRegistered (benchmark::State &state) {
+	const auto num_registered = static_cast<int>(state.range(0));
+	// Grows by segments of 16 enqueuers. Shared by the runs, which register increasing numbers of enqueuers.
+	static HelpQueue<int, 16> hq;
+	for (int id = 0; id < num_registered; ++id) {
+		hq.push_back(id, id);
+		(void) hq.try_pop_front(id);
+	}
+
+	int i = 0;
+	for (auto _ : state) {
+		hq.push_back(0, i);
+		benchmark::DoNotOptimize(hq.try_pop_front(i));
+		++i;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PushPopRegistered)
+	->RangeMultiplier(4)
+	->Range(1, 1024);
+
+/// \brief The baseline for using the queue as a work queue
+class MutexQueue {
+ public:
+  void push_back (int, int element) {
+	  const auto lock = std::scoped_lock{m_mutex};
+	  m_elements.push_back(element);
+  }
+
+  std::optional<int> pop_front (int) {
+	  const auto lock = std::scoped_lock{m_mutex};
+	  if (m_elements.empty()) { return std::nullopt; }
+	  const auto element = m_elements.front();
+	  m_elements.pop_front();
+	  return element;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::deque<int> m_elements;
+};
+
+/// \brief The conditional dequeue of the simulator used as a work queue: retried until the peeked element is dequeued
+class ConditionalPopQueue {
+ public:
+  void push_back (int id, int element) { m_queue.push_back(id, element); }
+
+  std::optional<int> pop_front (int) {
+	  while (auto front = m_queue.peek_front()) {
+		  if (m_queue.try_pop_front(front.value())) { return front; }
+	  }
+	  return std::nullopt;
+  }
+
+ private:
+  HelpQueue<int, MaxThreads> m_queue;
+};
+
+/// \brief Each thread enqueues an element and dequeues one, with the queue used as a general-purpose work queue
+template<typename Queue>
+static void BM_WorkQueue (benchmark::State &state) {
+	const int num_threads = static_cast<int>(state.range(0));
+	const int num_operations = static_cast<int>(state.range(1));
+	static Queue queue;
+
+	auto work = [&] (int id) {
+	  for (int i = 0; i < num_operations; ++i) {
+		  queue.push_back(id, i);
+		  benchmark::DoNotOptimize(queue.pop_front(id));
+	  }
+	};
+
+	for (auto _ : state) {
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(work, id);
+		for (auto &t : threads) t.join();
+	}
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_threads * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void sweep_threads (benchmark::internal::Benchmark *bench) {
+	for (int threads = 1; threads <= 16; threads *= 2) {
+		bench->Args({threads, 10000});
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_WorkQueue, MutexQueue)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WorkQueue, ConditionalPopQueue)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WorkQueue, HelpQueue<int, MaxThreads>)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
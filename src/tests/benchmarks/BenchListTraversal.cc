@@ -0,0 +1,46 @@
+#include <limits>
+
+#include <benchmark/benchmark.h>
+
+#include <samples/NormalizedLinkedList.hh>
+#include "PerfCounters.hh"
+
+using namespace normalizedlinkedlist;
+namespace versioning = tsim::versioning;
+
+/// \brief Traverse the whole list with `search` and report the number of cache misses per visited node. Compares the
+/// 	   representations of the successor links: a heap cell per version, an inline double word and a packed word.
+template<typename LinkRepr>
+static void BM_SearchTraversal (benchmark::State &state) {
+	const auto num_nodes = static_cast<int>(state.range(0));
+	LinkedList<int, LinkRepr> ll;
+	auto insertion = typename decltype(ll)::NormalizedInsert{ll};
+	tsim::ContentionFailureCounter failures;
+	// Descending insertion keeps every search at the head of the list
+	for (int i = num_nodes; i > 0; --i) {
+		(void) insertion.fast_path(i, failures);
+	}
+
+	telamon_benchmarks::PerfCounter cache_misses{PERF_COUNT_HW_CACHE_MISSES};
+	cache_misses.start();
+	for (auto _ : state) {
+		auto[left, right] = ll.search(std::numeric_limits<int>::max() - 1);
+		benchmark::DoNotOptimize(&left);
+		benchmark::DoNotOptimize(&right);
+	}
+	cache_misses.stop();
+
+	const auto visited = static_cast<double>(state.iterations()) * num_nodes;
+	state.counters["nodes"] = benchmark::Counter(visited, benchmark::Counter::kIsRate);
+	if (cache_misses.available()) {
+		state.counters["cache_misses_per_node"] = static_cast<double>(cache_misses.read_value()) / visited;
+	} else {
+		state.SetLabel("perf counters unavailable");
+	}
+}
+
+BENCHMARK_TEMPLATE(BM_SearchTraversal, versioning::ReferencedCells)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SearchTraversal, versioning::InlineDoubleWord)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SearchTraversal, versioning::PackedWord)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+#include <thread>
+#include <vector>
+#include <ranges>
+using namespace std::ranges::views;
+
+#include <benchmark/benchmark.h>
+
+#include <samples/NormalizedLinkedList.hh>
+#include <telamon/WaitFreeSimulator.hh>
+
+using namespace normalizedlinkedlist;
+
+/// \brief Slow-path insertions by a growing number of threads. With `Segment` smaller than the number of threads the state of
+/// 	   the simulator grows at runtime, otherwise it is sized up-front. The helping scans cover only the registered ids in
+/// 	   both cases, thus the two should scale alike while the growable one starts out smaller.
+template<int Segment>
+static void BM_SlowPathScaling (benchmark::State &state) {
+	const int num_threads = static_cast<int>(state.range(0));
+	const int num_operations = static_cast<int>(state.range(1));
+
+	for (auto _ : state) {
+		LinkedList<int> ll;
+		auto insertion = typename decltype(ll)::NormalizedInsert{ll};
+		using Handle = tsim::WaitFreeSimulatorHandle<decltype(insertion), Segment>;
+		auto insertion_sim = Handle{insertion, Handle::DEFAULT_HELP_DELAY, num_threads + 1};
+
+		auto insert = [&] (int id) {
+		  auto inserter = insertion_sim.fork();
+		  if (!inserter.has_value()) { return; }
+		  for (int i : iota(0, num_operations)) {
+			  benchmark::DoNotOptimize(inserter.value().submit(i * num_threads + id, true));
+		  }
+		  inserter.value().retire();
+		};
+
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(insert, id);
+		for (auto &t: threads) t.join();
+	}
+
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_threads * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void sweep_threads (benchmark::internal::Benchmark *bench) {
+	for (int threads = 1; threads <= 128; threads *= 2) {
+		bench->Args({threads, 100});
+	}
+}
+
+// Sized for the largest run up-front
+BENCHMARK_TEMPLATE(BM_SlowPathScaling, 129)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+// Grows by 16 ids
+BENCHMARK_TEMPLATE(BM_SlowPathScaling, 16)->Apply(sweep_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// \brief Slow-path insertions into independent lists, each with its own simulator and a single thread. The shards share no
+/// 	   state, thus the throughput should grow linearly with their number up to the number of cores.
+static void BM_ShardScaling (benchmark::State &state) {
+	const int num_shards = static_cast<int>(state.range(0));
+	const int num_operations = static_cast<int>(state.range(1));
+	using List = LinkedList<int>;
+	using Handle = tsim::WaitFreeSimulatorHandle<typename List::NormalizedInsert, 16>;
+
+	for (auto _ : state) {
+		std::vector<List> lists(num_shards);
+		std::vector<typename List::NormalizedInsert> insertions;
+		insertions.reserve(num_shards);
+		for (auto &ll : lists) { insertions.emplace_back(ll); }
+
+		auto insert = [&] (int shard) {
+		  auto inserter = Handle{insertions[shard], Handle::DEFAULT_HELP_DELAY, 1};
+		  for (int i : iota(0, num_operations)) {
+			  benchmark::DoNotOptimize(inserter.submit(i, true));
+		  }
+		};
+
+		std::vector<std::thread> threads;
+		for (int shard = 0; shard < num_shards; ++shard)
+			threads.emplace_back(insert, shard);
+		for (auto &t: threads) t.join();
+	}
+
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_shards * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_ShardScaling)->RangeMultiplier(2)->Ranges({{1, 64}, {100, 100}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,64 @@
+#include <thread>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include <telamon/Versioning.hh>
+
+using namespace telamon_simulator;
+
+/// \brief Resident set size of the process in KiB (Linux only)
+static auto resident_kib () -> long {
+	long pages_total = 0, pages_resident = 0;
+	std::ifstream statm{"/proc/self/statm"};
+	statm >> pages_total >> pages_resident;
+	return pages_resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/// \brief Sustained insert/remove-like load on a small set of links. Every successful CAS replaces a cell, so without
+/// 	   reclamation the resident memory grows linearly with the number of operations.
+static void BM_SoakCas (benchmark::State &state) {
+	const size_t num_threads = state.range(0);
+	const size_t num_operations = state.range(1);
+	constexpr int num_links = 16;
+
+	std::deque<versioning::VersionedAtomic<int>> links;
+	for (int i = 0; i < num_links; ++i) { links.emplace_back(0); }
+
+	auto churn = [&] (int id) {
+	  ContentionFailureCounter failures;
+	  for (size_t i = 0; i < num_operations; ++i) {
+		  auto &link = links[(id + i) % num_links];
+		  auto loaded = link.load();
+		  (void) link.compare_exchange_strong(loaded->value, loaded->version, loaded->value + 1, failures);
+	  }
+	};
+
+	const auto rss_before = resident_kib();
+	long rss_peak = rss_before;
+	for (auto _ : state) {
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(churn, id);
+		for (auto &t : threads) t.join();
+		rss_peak = std::max(rss_peak, resident_kib());
+	}
+
+	state.counters["rss_growth_kib"] = static_cast<double>(rss_peak - rss_before);
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_threads * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_SoakCas)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+	->Args({2 << 0, 100000})
+	->Args({2 << 1, 100000})
+	->Args({2 << 2, 100000})
+	->Args({2 << 3, 100000})
+	->Args({2 << 1, 1000000})
+	->Args({2 << 3, 1000000});
+
+BENCHMARK_MAIN();
@@ -50,4 +50,40 @@ BENCHMARK(BM_Insertion)
 	->Args({2 << 4, 1000})
 	->Args({2 << 5, 1000});
 
+/// \brief Same as BM_Insertion, but the help delay of the handles is the third argument. A delay of 1 checks the help queue
+/// 	   before every operation.
+static void BM_InsertionHelpDelay (benchmark::State &state) {
+	const size_t num_threads = state.range(0);
+	const size_t num_operations = state.range(1);
+	const int help_delay = static_cast<int>(state.range(2));
+
+	for (auto _ : state) {
+		LinkedList<int> ll;
+		auto norm_insertion = decltype(ll)::NormalizedInsert{ll};
+		auto wf_insertion_sim = tsim::WaitFreeSimulatorHandle<decltype(norm_insertion), 65>{norm_insertion, help_delay};
+
+		auto insert = [&] (int id) {
+		  if (auto opt = wf_insertion_sim.fork(); opt.has_value()) {
+			  auto handle = opt.value();
+			  for (int i : iota(num_operations * id) | take(num_operations)) {
+				  handle.submit(i);
+			  }
+			  handle.retire();
+		  }
+		};
+
+		std::vector<std::thread> threads;
+		for (int id = 0; id < num_threads; ++id)
+			threads.emplace_back(insert, id);
+		for (auto &t: threads) t.join();
+	}
+
+	state.counters["ops"] = benchmark::Counter(static_cast<double>(num_threads * num_operations), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_InsertionHelpDelay)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+	->ArgsProduct({{2 << 0, 2 << 1, 2 << 2, 2 << 3}, {1000}, {1, 4, 16, 64}});
+
 BENCHMARK_MAIN();
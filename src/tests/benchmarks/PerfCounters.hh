@@ -0,0 +1,66 @@
+#ifndef TELAMON_BENCHMARKS_PERF_COUNTERS_HH
+#define TELAMON_BENCHMARKS_PERF_COUNTERS_HH
+
+//! \file 		PerfCounters.hh
+//! \brief 		A minimal wrapper around perf_event_open used by the benchmarks to read hardware counters (Linux only)
+//! \details 	The counters count the calling thread only. When perf events are not available (e.g. in a container or with
+//! 			a restrictive perf_event_paranoid) `available` is false and every read returns 0.
+
+#include <cstdint>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace telamon_benchmarks {
+
+/// \brief A single hardware counter of the calling thread
+class PerfCounter {
+ public:
+  explicit PerfCounter (uint64_t config, uint32_t type = PERF_TYPE_HARDWARE) {
+	  perf_event_attr attr{};
+	  std::memset(&attr, 0, sizeof(attr));
+	  attr.size = sizeof(attr);
+	  attr.type = type;
+	  attr.config = config;
+	  attr.disabled = 1;
+	  attr.exclude_kernel = 1;
+	  attr.exclude_hv = 1;
+	  m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  PerfCounter (const PerfCounter &) = delete;
+  auto operator= (const PerfCounter &) -> PerfCounter & = delete;
+
+  ~PerfCounter () {
+	  if (available()) { close(m_fd); }
+  }
+
+ public:
+  [[nodiscard]] auto available () const noexcept -> bool { return m_fd >= 0; }
+
+  void start () noexcept {
+	  if (!available()) { return; }
+	  ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+	  ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  void stop () noexcept {
+	  if (available()) { ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0); }
+  }
+
+  [[nodiscard]] auto read_value () const noexcept -> uint64_t {
+	  uint64_t value = 0;
+	  if (!available() || read(m_fd, &value, sizeof(value)) != sizeof(value)) { return 0; }
+	  return value;
+  }
+
+ private:
+  int m_fd{-1};
+};
+
+}
+
+#endif // TELAMON_BENCHMARKS_PERF_COUNTERS_HH
@@ -20,7 +20,9 @@ namespace normalizedlinkedlist {
 /// \brief 		Implementation of Harris' Linked list
 /// \details 	This is the original paper https://www.microsoft.com/en-us/research/wp-content/uploads/2001/10/2001-disc.pdf
 /// \tparam 	T Has to be either an integral type or a floating type
-template<typename T> requires std::integral<T> || std::floating_point<T>
+/// \tparam 	LinkRepr The representation of the successor links (see Versioning.hh). Inline by default, so that traversing and
+/// 			CAS-ing a link neither allocates nor chases a pointer.
+template<typename T, typename LinkRepr = tsim::versioning::InlineDoubleWord> requires std::integral<T> || std::floating_point<T>
 class LinkedList {
  public:
   struct MarkMeta {
@@ -31,7 +33,7 @@ class LinkedList {
 
   class Node {
    public:
-	using SuccessorLink = tsim::versioning::VersionedAtomic<Node *, MarkMeta>;
+	using SuccessorLink = tsim::versioning::VersionedAtomic<Node *, MarkMeta, LinkRepr>;
 	explicit Node (const T &value, Node *next = nullptr) : m_value{value}, m_next{next} {}
 
    public:
@@ -82,40 +84,38 @@ class LinkedList {
   }
 
  public:
+  /// \brief Find the adjacent nodes left and right, such that left < value <= right and neither of them is removed
+  /// \details The removed nodes between left and right are unlinked on the way. A removed node is a marked copy of the
+  /// 		   node it replaced, thus it is skipped rather than taken as either of the two.
   auto search (T value) -> std::pair<Node &, Node &> {
 	  tsim::ContentionFailureCounter failures{};
-	  Node *left_ptr{nullptr};
-	  Node *left_next{nullptr};
 	  while (true) {
-		  Node *right_ptr{nullptr};
-		  Node *current = head();
-		  Node *next = head()->next();
+		  Node *left_ptr = head();
+		  Node *left_next = left_ptr->next();
+		  Node *right_ptr = left_next;
 
 		  /// 1. Find left and right pointers
-		  for (/* empty */; is_removed(next) || current->value() < value; next = current->next()) {
-			  if (!is_removed(next)) {
-				  left_ptr = current;
-				  left_next = next;
-			  }
-			  current = next;
-			  if (current == tail()) {
-				  break;
+		  while (right_ptr != tail() && (is_removed(right_ptr) || right_ptr->value() < value)) {
+			  if (!is_removed(right_ptr)) {
+				  left_ptr = right_ptr;
+				  left_next = right_ptr->next();
 			  }
+			  right_ptr = right_ptr->next();
 		  }
-		  right_ptr = current;
 
 		  /// 2. Check nodes are adjacent
 		  if (left_next == right_ptr) {
-			  if (right_ptr != tail() && right_ptr->next()->is_removed()) continue;
+			  if (is_removed(right_ptr)) continue;
 			  return std::pair<Node &, Node &>{*left_ptr, *right_ptr};
 		  }
 
 		  /// 3. Remove one or more marked nodes
-		  if (left_ptr && left_ptr->next_atomic().compare_exchange_strong(left_next, left_ptr->version(), right_ptr, left_ptr->meta(), failures)) {
+		  if (left_ptr->next_atomic().compare_exchange_strong(left_next, left_ptr->version(), right_ptr, left_ptr->meta(), failures)) {
 			  m_deleted.fetch_add(1);
+			  if (!is_removed(right_ptr)) {
+				  return std::pair<Node &, Node &>{*left_ptr, *right_ptr};
+			  }
 		  }
-		  if (right_ptr != m_tail && right_ptr->next()->is_removed()) continue;
-		  return std::pair<Node &, Node &>{*left_ptr, *right_ptr};
 	  }
   }
 
@@ -178,7 +178,7 @@ class LinkedList {
    public:
 	class CasDescriptor {
 	 public:
-	  CasDescriptor (tsim::versioning::VersionedAtomic<Node *, MarkMeta> &t_target, Node *t_expected, Node *t_desired)
+	  CasDescriptor (typename Node::SuccessorLink &t_target, Node *t_expected, Node *t_desired)
 		  : m_target{t_target},
 		    m_expected{t_expected},
 		    m_desired{t_desired} {}
@@ -207,14 +207,19 @@ class LinkedList {
 	  }
 
 	  [[nodiscard]] auto execute (tsim::ContentionFailureCounter &failures) noexcept -> nonstd::expected<bool, std::monostate> {
-		  return m_target.compare_exchange_strong(m_expected, m_target.version(), m_desired, m_desired->meta(), failures);
+		  if (m_target.compare_exchange_strong(m_expected, m_target.version(), m_desired, m_desired->meta(), failures)) {
+			  return true;
+		  }
+		  // Performed by another helper already: the desired node is linked by this commit only
+		  return m_target.load()->value == m_desired;
 	  }
 
 	 private:
-	  std::atomic<tsim::CasStatus> m_state{tsim::CasStatus::Pending};
-	  tsim::versioning::VersionedAtomic<Node *, MarkMeta> &m_target;
+	  typename Node::SuccessorLink &m_target;
 	  Node *m_expected;
 	  Node *m_desired;
+	  /// Written by the helpers, on its own line so that it does not invalidate the read-only fields above
+	  alignas(64) std::atomic<tsim::CasStatus> m_state{tsim::CasStatus::Pending};
 	};
 	static_assert(std::is_copy_constructible_v<CasDescriptor>, "Commit type has to be copy-constructible.");
 	static_assert(tsim::CasWithVersioning<CasDescriptor>, "Commit type has implement versioning.");
@@ -243,7 +248,8 @@ class LinkedList {
 			return std::make_optional(true);
 		}
 		(void) failures;
-		return nonstd::make_unexpected(std::monostate{});
+		// The CAS lost to another update of its target, thus the insertion is restarted
+		return std::optional<Output>{};
 	}
 
 	/// \brief Client implementation for the fast-path algorithm
@@ -264,7 +270,7 @@ class LinkedList {
 	}
 
    private:
-	LinkedList<T> &m_lockfree;
+	LinkedList &m_lockfree;
   };
   static_assert(tsim::NormalizedRepresentation<NormalizedInsert>, "Insert is not normalized.");
 
@@ -272,7 +278,7 @@ class LinkedList {
    public:
 	class CasDescriptor {
 	 public:
-	  CasDescriptor (tsim::versioning::VersionedAtomic<Node *, MarkMeta> &t_target, Node *t_expected, Node *t_desired)
+	  CasDescriptor (typename Node::SuccessorLink &t_target, Node *t_expected, Node *t_desired)
 		  : m_target{t_target},
 		    m_expected{t_expected},
 		    m_desired{t_desired} {}
@@ -303,14 +309,19 @@ class LinkedList {
 	  }
 
 	  [[nodiscard]] auto execute (tsim::ContentionFailureCounter &failures) noexcept -> nonstd::expected<bool, std::monostate> {
-		  return m_target.template compare_exchange_strong(m_expected, m_target.version(), m_desired, m_desired->meta(), failures);
+		  if (m_target.template compare_exchange_strong(m_expected, m_target.version(), m_desired, m_desired->meta(), failures)) {
+			  return true;
+		  }
+		  // Performed by another helper already: the desired node is linked by this commit only
+		  return m_target.load()->value == m_desired;
 	  }
 
 	 private:
-	  std::atomic<tsim::CasStatus> m_state{tsim::CasStatus::Pending};
-	  tsim::versioning::VersionedAtomic<Node *, MarkMeta> &m_target;
+	  typename Node::SuccessorLink &m_target;
 	  Node *m_expected;
 	  Node *m_desired;
+	  /// Written by the helpers, on its own line so that it does not invalidate the read-only fields above
+	  alignas(64) std::atomic<tsim::CasStatus> m_state{tsim::CasStatus::Pending};
 	};
 	static_assert(tsim::CasWithVersioning<CasDescriptor>, "Commit type has to implement versioning.");
 	static_assert(std::is_copy_constructible_v<CasDescriptor>, "Commit type has to be copy-constructible.");
@@ -320,13 +331,13 @@ class LinkedList {
 	using Output = bool;
 	using Commit = std::array<CasDescriptor, 1>;
 
-	explicit NormalizedRemove (LinkedList<T> &t_lf) : m_lockfree{t_lf} {}
+	explicit NormalizedRemove (LinkedList &t_lf) : m_lockfree{t_lf} {}
    public:
 
 	auto generator (const Input &inp, tsim::ContentionFailureCounter &failures) -> std::optional<Commit> {
 		auto[left, right] = m_lockfree.search(inp);
 		if (right.value() != inp) { return std::nullopt; }
-		auto *updated_node = new Node{inp, &right};
+		auto *updated_node = new Node{inp, right.next()};
 		updated_node->mark();
 		auto &left_next = left.next_atomic();
 		auto commit_ = Commit{CasDescriptor{left_next, &right, updated_node}};
@@ -342,7 +353,8 @@ class LinkedList {
 		if (executed.has_value()) {
 			return std::make_optional(true);
 		}
-		return nonstd::make_unexpected(std::monostate{});
+		// The CAS lost to another update of its target, thus the removal is restarted
+		return std::optional<Output>{};
 	}
 
 	auto fast_path (const Input &inp, tsim::ContentionFailureCounter &failures) -> std::optional<Output> {
@@ -359,7 +371,7 @@ class LinkedList {
 		auto left_next_version = left.next_atomic().transform([] (auto _v, auto version, auto _m) { return version; });
 		auto left_next_meta = left.next_atomic().transform([] (auto _v, auto _ve, auto meta) { return meta; });
 		if (!left.next_atomic().compare_exchange_strong(&right, left_next_version, updated_node, left_next_meta, failures)) {
-			return std::make_optional(false);
+			return std::nullopt;   //< Lost a race with a neighbouring update, the node may still be present
 		}
 
 		m_lockfree.m_size.fetch_sub(1);
@@ -367,7 +379,7 @@ class LinkedList {
 	}
 
    private:
-	LinkedList<T> &m_lockfree;
+	LinkedList &m_lockfree;
   };
   static_assert(tsim::NormalizedRepresentation<NormalizedRemove>, "Remove is not normalized.");
 